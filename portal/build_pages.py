@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+"""
+File: build_pages.py
+Description: Compresses the portal pages in this directory with gzip and writes them as byte arrays to
+             src/ecomonitor/PortalPages.h, so the device serves them from flash as they are. Run it after
+             changing a page: python3 portal/build_pages.py
+Author: Andriy Tymchuk
+Created: 2026-10-17
+"""
+
+import gzip
+import os
+
+PAGES = [("index.html", "portalIndexPage"), ("saved.html", "portalSavedPage")]
+
+here = os.path.dirname(os.path.abspath(__file__))
+output = os.path.join(here, "..", "src", "ecomonitor", "PortalPages.h")
+
+lines = [
+    "/*",
+    " * File: PortalPages.h",
+    " * Description: Gzip-compressed portal pages, generated from the pages in portal/ by portal/build_pages.py.",
+    " *              Do not edit by hand.",
+    " * Author: Andriy Tymchuk",
+    " * Created: 2026-10-17",
+    "*/",
+    "",
+    "#pragma once",
+    "",
+    "#ifndef ECOMONITOR_PORTAL_PAGES_H",
+    "#define ECOMONITOR_PORTAL_PAGES_H",
+    "",
+    "#include <Arduino.h>",
+    "",
+]
+
+for filename, name in PAGES:
+    with open(os.path.join(here, filename), "rb") as page:
+        source = page.read()
+    # mtime=0 keeps the output identical between runs
+    data = gzip.compress(source, compresslevel=9, mtime=0)
+    lines.append("// %s: %d bytes, %d compressed" % (filename, len(source), len(data)))
+    lines.append("static const uint8_t %s[] = {" % name)
+    for i in range(0, len(data), 16):
+        lines.append("    " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    lines.append("};")
+    lines.append("")
+
+lines.append("#endif")
+
+with open(output, "w", newline="\n") as header:
+    header.write("\n".join(lines) + "\n")
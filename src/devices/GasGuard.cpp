@@ -2,16 +2,9 @@
 // Created by andri on 16.12.2025.
 //
 
-#include <WebServer.h>
-#include <HTTPClient.h>
-#include <WiFi.h>
-#include <Preferences.h>
-#include <ArduinoJson.h>
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
-
 #include "GasGuard.h"
 
+#include "ecomonitor/Alarm.h"
 #include "ecomonitor/EcoMonitor.h"
 #include "ecomonitor/sensors/MQ7_Sensor.h"
 
@@ -22,6 +15,7 @@ void setupGasGuard() {
     setDevicePrefix("GG-");
     setMeasurementUnit(" ppm");
     setApiBaseUrl("https://ecomonitor-znv9.onrender.com/api");
+    setAlarmSamplePeriod(ALARM_SAMPLE_PERIOD);  // The MQ7 is an ADC read, cheap enough to watch CO closely
 
     EcoMonitor::begin(&mq7_sensor);
 }
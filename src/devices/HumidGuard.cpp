@@ -2,16 +2,6 @@
 // Created by andri on 16.12.2025.
 //
 
-#include <WebServer.h>
-#include <HTTPClient.h>
-#include <WiFi.h>
-#include <Preferences.h>
-#include <ArduinoJson.h>
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
-#include "Adafruit_Sensor.h"
-#include "Adafruit_AM2320.h"
-
 #include "HumidGuard.h"
 
 #include "ecomonitor/EcoMonitor.h"
@@ -0,0 +1,55 @@
+/*
+ * File: Alarm.cpp
+ * Description: Alarm rules, see Alarm.h.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include "Alarm.h"
+
+AlarmEvent AlarmDetector::check(const Sample& sample) {
+    lastRise = riseOver(sample);
+    history.push(sample);
+
+    bool aboveLevel = threshold > 0 && sample.value >= threshold;
+    bool rising = riseRate > 0 && lastRise >= riseRate;
+    // Inside the hysteresis band the alarm keeps its state
+    bool belowLevel = threshold <= 0 || sample.value < threshold - hysteresis;
+
+    bool changing = isActive ? belowLevel && !rising : aboveLevel || rising;
+    streak = changing ? streak + 1 : 0;
+    if (streak < ALARM_CONFIRM_SAMPLES) return ALARM_NO_CHANGE;
+
+    streak = 0;
+    isActive = !isActive;
+    activeCause = !isActive ? CAUSE_NONE : aboveLevel ? CAUSE_LEVEL : CAUSE_RISE;
+    return isActive ? ALARM_TRIPPED : ALARM_CLEARED;
+}
+
+void AlarmDetector::reset() {
+    history.clear();
+    isActive = false;
+    activeCause = CAUSE_NONE;
+    streak = 0;
+    lastRise = 0;
+}
+
+// Slope from the newest sample at least ALARM_RISE_WINDOW old, 0 while the history does not reach that far
+float AlarmDetector::riseOver(const Sample& sample) const {
+    for (size_t age = 0; age < history.size(); age++) {
+        const Sample& past = history.newest(age);
+        unsigned long elapsed = sample.timestamp - past.timestamp;
+        if (elapsed >= ALARM_RISE_WINDOW) {
+            return (sample.value - past.value) / (elapsed / 60000.0f);
+        }
+    }
+    return 0;
+}
+
+const char* AlarmDetector::causeName(AlarmCause cause) {
+    switch (cause) {
+        case CAUSE_LEVEL: return "level";
+        case CAUSE_RISE: return "rise";
+        default: return "none";
+    }
+}
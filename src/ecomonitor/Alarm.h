@@ -0,0 +1,73 @@
+/*
+ * File: Alarm.h
+ * Description: Alarm rules evaluated on every sample: the value reaching the alarm level, or rising faster
+ *              than the rise rate. The alarm clears once the value is back below the level by the hysteresis
+ *              and no longer rising that fast. A rule has to hold for ALARM_CONFIRM_SAMPLES samples in a row
+ *              before the state changes, so a single noisy ADC reading neither trips nor clears it.
+ *              Devices with a fast sensor (GasGuard) sample for the alarm every ALARM_SAMPLE_PERIOD ms instead
+ *              of the 5 s of the regular samples; a trip or clear is uploaded at once, past the upload batch.
+ *              The level, hysteresis and rise rate are set with the change_alarm_level, change_alarm_hysteresis
+ *              and change_alarm_rise commands.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_ALARM_H
+#define ECOMONITOR_ALARM_H
+
+#include <Arduino.h>
+
+#include "RingBuffer.h"
+#include "Sampler.h"
+
+#ifndef ALARM_SAMPLE_PERIOD
+#define ALARM_SAMPLE_PERIOD 250     // ms between two alarm samples on devices that enable them (setAlarmSamplePeriod)
+#endif
+#ifndef ALARM_HYSTERESIS
+#define ALARM_HYSTERESIS 0          // Units the value must fall below the level to clear the alarm
+#endif
+#ifndef ALARM_RISE_RATE
+#define ALARM_RISE_RATE 0           // Units per minute that trip the alarm, 0 turns the rule off
+#endif
+#define ALARM_RISE_WINDOW 10000     // ms the rise is measured over, longer than the noise between two samples
+#define ALARM_CONFIRM_SAMPLES 2     // Samples in a row a rule must hold to trip or clear the alarm
+#define ALARM_REPEAT_INTERVAL 60000 // ms between two uploads while the alarm stays on
+#define ALARM_HISTORY_SIZE 64       // Samples kept for the rise, covers ALARM_RISE_WINDOW down to a 160 ms period
+
+enum AlarmEvent { ALARM_NO_CHANGE, ALARM_TRIPPED, ALARM_CLEARED };
+enum AlarmCause { CAUSE_NONE, CAUSE_LEVEL, CAUSE_RISE };
+
+class AlarmDetector {
+public:
+    void setLevel(float value) { threshold = value; }
+    void setHysteresis(float units) { hysteresis = units; }
+    void setRiseRate(float unitsPerMinute) { riseRate = unitsPerMinute; }
+
+    bool armed() const { return threshold > 0 || riseRate > 0; }
+    bool active() const { return isActive; }
+    AlarmCause cause() const { return activeCause; }
+    float level() const { return threshold; }
+    float rise() const { return lastRise; }          // Units per minute over the window, 0 until it is covered
+
+    AlarmEvent check(const Sample& sample);
+    void reset();                                    // Off, with the rise window empty
+
+    static const char* causeName(AlarmCause cause);
+
+private:
+    float riseOver(const Sample& sample) const;
+
+    float threshold = 0;            // 0 turns the level rule off
+    float hysteresis = ALARM_HYSTERESIS;
+    float riseRate = ALARM_RISE_RATE;
+
+    RingBuffer<Sample, ALARM_HISTORY_SIZE> history;
+    bool isActive = false;
+    AlarmCause activeCause = CAUSE_NONE;
+    uint8_t streak = 0;
+    float lastRise = 0;
+};
+
+#endif
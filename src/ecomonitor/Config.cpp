@@ -0,0 +1,105 @@
+/*
+ * File: Config.cpp
+ * Description: Configuration cache, see Config.h.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include "Config.h"
+#include "Alarm.h"
+#include "DutyCycle.h"
+#include "MqttChannel.h"
+#include "ReportPolicy.h"
+#include "Uploader.h"
+
+#define CONFIG_KEY "device"
+
+static DeviceConfig current;
+static bool dirty = false;
+
+static void setDefaults(DeviceConfig& config) {
+    memset(&config, 0, sizeof(config)); // Padding included, so equal settings give an equal blob
+    config.version = CONFIG_VERSION;
+    config.deepSleep = DEEP_SLEEP_MODE;
+    config.readingMinutes = 15;
+    config.batchAgeMinutes = UPLOAD_BATCH_MAX_AGE;
+    config.batchSize = UPLOAD_BATCH_SIZE;
+    config.encoding = UPLOAD_ENCODING;
+    config.deadband = REPORT_DEADBAND;
+    config.rateBand = REPORT_RATE_BAND;
+    config.alarmLevel = SLEEP_ALARM_LEVEL;
+    config.alarmHysteresis = ALARM_HYSTERESIS;
+    config.alarmRise = ALARM_RISE_RATE;
+    strlcpy(config.mqttBroker, MQTT_BROKER, sizeof(config.mqttBroker));
+    config.mqttPort = MQTT_PORT;
+}
+
+// Firmware before the blob kept its settings under a key of its own; these five are all it ever released
+static const char* const legacyKeys[] = {"isConfigured", "sta_ssid", "sta_password", "reading_time", "api_base_url"};
+
+static void migrate(StorageInterface& prefs, DeviceConfig& config) {
+    config.configured = prefs.getBool("isConfigured");
+    strlcpy(config.ssid, prefs.getString("sta_ssid").c_str(), sizeof(config.ssid));
+    strlcpy(config.password, prefs.getString("sta_password").c_str(), sizeof(config.password));
+    config.readingMinutes = prefs.getString("reading_time", "15").toInt();
+    strlcpy(config.apiBaseUrl, prefs.getString("api_base_url").c_str(), sizeof(config.apiBaseUrl));
+}
+
+static void validate(DeviceConfig& config) {
+    config.ssid[sizeof(config.ssid) - 1] = '\0';
+    config.password[sizeof(config.password) - 1] = '\0';
+    config.apiBaseUrl[sizeof(config.apiBaseUrl) - 1] = '\0';
+    config.mqttBroker[sizeof(config.mqttBroker) - 1] = '\0';
+    if (config.mqttPort == 0) config.mqttPort = MQTT_PORT;
+    if (config.ssid[0] == '\0') config.configured = false;
+    if (config.readingMinutes == 0 || config.readingMinutes > 1440) config.readingMinutes = 15;
+    if (config.batchAgeMinutes == 0 || config.batchAgeMinutes > 1440) config.batchAgeMinutes = UPLOAD_BATCH_MAX_AGE;
+    config.batchSize = constrain(config.batchSize, 1, UPLOAD_BATCH_MAX);
+    if (config.encoding != PAYLOAD_MSGPACK) config.encoding = PAYLOAD_JSON;
+}
+
+namespace Config {
+    void load() {
+        StorageInterface& prefs = Hal::storage();
+        setDefaults(current);
+
+        DeviceConfig stored;
+        size_t length = prefs.getBytes(CONFIG_KEY, &stored, sizeof(stored));
+        bool migrated = length != sizeof(stored) || stored.version != CONFIG_VERSION;
+        if (!migrated) {
+            current = stored;
+            dirty = false;
+        } else {
+            Serial.println("Migrating configuration");
+            migrate(prefs, current);
+            dirty = true;
+        }
+        validate(current);
+        if (!migrated) return;
+
+        // The old keys only go once the blob reads back; a power cut before that migrates again
+        flush();
+        if (prefs.getBytes(CONFIG_KEY, &stored, sizeof(stored)) == sizeof(stored)) {
+            for (const char* key : legacyKeys) prefs.remove(key);
+        }
+    }
+
+    const DeviceConfig& get() { return current; }
+
+    DeviceConfig& edit() {
+        dirty = true;
+        return current;
+    }
+
+    bool flush() {
+        if (!dirty) return false;
+        Hal::storage().putBytes(CONFIG_KEY, &current, sizeof(current));
+        dirty = false;
+        return true;
+    }
+
+    void reset() {
+        setDefaults(current);
+        dirty = true;
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * File: Config.h
+ * Description: Typed copy of the device configuration in RAM. It is read from NVS once at boot, as one
+ *              versioned blob, and the loop reads the struct for free. Changes only mark it dirty; flush()
+ *              writes the whole struct back in a single NVS commit, so several changes in one loop pass
+ *              (e.g. a batch of commands) cost one write. A device still on the per-key layout of older
+ *              firmware is migrated on its first boot, and the old keys are erased once the blob is stored.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_CONFIG_H
+#define ECOMONITOR_CONFIG_H
+
+#include <Arduino.h>
+
+#include "hal/Hal.h"
+
+// Bump it when the layout of DeviceConfig changes, and upgrade the older blob in Config::load()
+#define CONFIG_VERSION 1
+
+struct DeviceConfig {
+    uint16_t version;
+    bool configured;            // Wi-Fi credentials were entered in the portal
+    bool deepSleep;
+    char ssid[33];
+    char password[65];
+    char apiBaseUrl[96];        // Empty: the default of the device type
+    uint16_t readingMinutes;
+    uint16_t batchAgeMinutes;
+    uint8_t batchSize;
+    uint8_t encoding;           // PayloadEncoding
+    float deadband;
+    float rateBand;
+    float alarmLevel;
+    StationHint stationHint;    // Channel 0: nothing cached
+    float alarmHysteresis;
+    float alarmRise;
+    char mqttBroker[64];        // Empty: no MQTT channel
+    uint16_t mqttPort;
+};
+
+namespace Config {
+    void load();                // Once at boot, after the storage has been opened
+    const DeviceConfig& get();
+    DeviceConfig& edit();       // Marks the configuration dirty, the next flush() writes it
+    bool flush();               // true if it had changes and was written
+    void reset();               // Back to the defaults, written by the next flush()
+}
+
+#endif
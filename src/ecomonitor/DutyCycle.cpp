@@ -0,0 +1,96 @@
+/*
+ * File: DutyCycle.cpp
+ * Description: Low-power mode, see DutyCycle.h.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include "DutyCycle.h"
+#include "Gorilla.h"
+#include "IntervalStats.h"
+#include "hal/Hal.h"
+
+// RTC slow memory keeps these through deep sleep; a cold boot starts them from zero
+RTC_DATA_ATTR static GorillaBlock<SLEEP_BUFFER_BYTES> sampleBuffer;
+RTC_DATA_ATTR static bool alarmActive = false;
+RTC_DATA_ATTR static WakeStats wakeStats = {0, 0, 0, 0, 0, 0};
+
+// The block cannot drop from its front, so the rest is compressed again
+static void dropOldest() {
+    GorillaBlock<SLEEP_BUFFER_BYTES> rest;
+    rest.clear();
+    GorillaReader reader = sampleBuffer.reader();
+    uint32_t epoch;
+    float value;
+    reader.next(epoch, value);
+    while (reader.next(epoch, value)) rest.append(epoch, value);
+    sampleBuffer = rest;
+}
+
+namespace DutyCycle {
+    bool isWake() { return Hal::system().wokeFromSleep(); }
+
+    size_t add(const Sample& sample) {
+        // Only happens if uploads keep failing to start; the oldest sample makes room
+        if (sampleBuffer.size() == SLEEP_BUFFER_SIZE) dropOldest();
+        while (!sampleBuffer.append(sample.epoch, sample.value)) dropOldest();
+        return sampleBuffer.size();
+    }
+
+    size_t buffered() { return sampleBuffer.size(); }
+    bool bufferFull() { return sampleBuffer.size() >= SLEEP_BUFFER_SIZE || sampleBuffer.isFull(); }
+
+    bool alarmChanged(float value, float level) {
+        if (level <= 0) return false;
+        bool above = value >= level;
+        if (above == alarmActive) return false;
+        alarmActive = above;
+        return true;
+    }
+
+    Reading closeBuffer() {
+        IntervalStats stats;
+        uint32_t epoch = 0;
+        float value = 0;
+        GorillaReader reader = sampleBuffer.reader();
+        while (reader.next(epoch, value)) {
+            stats.add(value);
+        }
+
+        Reading reading = {};   // Only the device's own value is buffered across sleeps
+        reading.timestamp = millis();
+        reading.epoch = epoch;
+        reading.value = value;
+        reading.min = stats.min();
+        reading.max = stats.max();
+        reading.mean = stats.mean();
+        reading.stddev = stats.stddev();
+        reading.count = stats.samples();
+        sampleBuffer.clear();
+        return reading;
+    }
+
+    void endWake(unsigned long awakeMicros, bool radio) {
+        wakeStats.wakes++;
+        if (radio) {
+            wakeStats.radioWakes++;
+            wakeStats.radioAwakeMicros += awakeMicros;
+            if (awakeMicros > wakeStats.maxRadioAwakeMicros) wakeStats.maxRadioAwakeMicros = awakeMicros;
+        } else {
+            wakeStats.awakeMicros += awakeMicros;
+            if (awakeMicros > wakeStats.maxAwakeMicros) wakeStats.maxAwakeMicros = awakeMicros;
+        }
+        Serial.printf("Wake %lu%s: %lu us awake, %u buffered\n", (unsigned long)wakeStats.wakes,
+                      radio ? " (Wi-Fi)" : "", awakeMicros, (unsigned)sampleBuffer.size());
+    }
+
+    void sleep(unsigned long awakeMicros) {
+        // The time spent awake comes off the sleep, so the samples stay SLEEP_SAMPLE_INTERVAL apart
+        uint64_t interval = SLEEP_SAMPLE_INTERVAL * 1000000ULL;
+        uint64_t sleepMicros = awakeMicros < interval ? interval - awakeMicros : interval;
+        Serial.flush();
+        Hal::system().deepSleep(sleepMicros);
+    }
+
+    const WakeStats& stats() { return wakeStats; }
+}
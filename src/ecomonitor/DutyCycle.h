@@ -0,0 +1,65 @@
+/*
+ * File: DutyCycle.h
+ * Description: Low-power mode for battery units. The device sleeps in deep sleep and wakes on the RTC timer
+ *              every SLEEP_SAMPLE_INTERVAL seconds, takes one sample into a buffer in RTC slow memory (which
+ *              survives deep sleep) and goes back to sleep without touching the display, Wi-Fi or the web server.
+ *              The samples are compressed as they come in, so a slowly changing value buffers for hours.
+ *              Wi-Fi only comes up once the buffer holds a whole reporting interval or is full, or when the value
+ *              crosses the alarm level; the buffer is then uploaded as one reading with its summary.
+ *              A cold boot stays awake for SLEEP_AWAKE_WINDOW first (display, portal, NTP, first upload).
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_DUTY_CYCLE_H
+#define ECOMONITOR_DUTY_CYCLE_H
+
+#include <Arduino.h>
+
+#include "Sampler.h"
+
+// Off by default; can be switched at runtime with the change_deep_sleep command ("1" / "0")
+#ifndef DEEP_SLEEP_MODE
+#define DEEP_SLEEP_MODE 0
+#endif
+#ifndef SLEEP_SAMPLE_INTERVAL
+#define SLEEP_SAMPLE_INTERVAL 60    // Seconds between two wakes
+#endif
+#ifndef SLEEP_BUFFER_SIZE
+#define SLEEP_BUFFER_SIZE 240       // Samples kept in RTC slow memory at most
+#endif
+#ifndef SLEEP_BUFFER_BYTES
+#define SLEEP_BUFFER_BYTES 480      // Gorilla block they are compressed into (Gorilla.h), as much as 60 raw samples took
+#endif
+#ifndef SLEEP_ALARM_LEVEL
+#define SLEEP_ALARM_LEVEL 0         // Crossing it in either direction uploads at once, 0 turns it off (change_alarm_level)
+#endif
+#define SLEEP_AWAKE_WINDOW 120000   // ms a cold boot stays awake before it starts duty cycling
+#define SLEEP_WIFI_TIMEOUT 10000    // ms a wake waits for Wi-Fi before it keeps the reading in the journal
+
+// Kept in RTC memory across wakes
+struct WakeStats {
+    uint32_t wakes;
+    uint32_t radioWakes;            // Wakes that brought Wi-Fi up
+    uint64_t awakeMicros;           // Total over the sample-only wakes
+    uint64_t radioAwakeMicros;      // Total over the Wi-Fi wakes
+    uint32_t maxAwakeMicros;
+    uint32_t maxRadioAwakeMicros;
+};
+
+namespace DutyCycle {
+    bool isWake();                          // This boot is a timer wake from duty-cycle sleep
+    size_t add(const Sample& sample);       // Buffers the sample, returns how many are buffered
+    size_t buffered();
+    bool bufferFull();                      // Another sample might not fit without dropping the oldest
+    bool alarmChanged(float value, float level); // The value crossed the level since the last wake
+    Reading closeBuffer();                  // Summary of the buffered samples, ending with the newest; empties the buffer
+
+    void endWake(unsigned long awakeMicros, bool radio);  // Logs the wake and adds it to the statistics
+    void sleep(unsigned long awakeMicros);  // Deep sleep until the next sample is due; does not return on the ESP32
+    const WakeStats& stats();
+}
+
+#endif
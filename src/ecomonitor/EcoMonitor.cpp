@@ -5,100 +5,411 @@
  * Created: 2025-12-17
 */
 
-#include <Wire.h>
-#include <WiFi.h>
-#include <WebServer.h>
-#include <HTTPClient.h>
-#include <Preferences.h>
 #include <ArduinoJson.h>
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
+#include <algorithm>
+#include <atomic>
 
 #include "EcoMonitor.h"
+#include "Alarm.h"
+#include "Config.h"
+#include "DutyCycle.h"
+#include "LiveStream.h"
+#include "MqttChannel.h"
+#include "Payload.h"
+#include "Portal.h"
+#include "Profiler.h"
+#include "ReportPolicy.h"
+#include "Scheduler.h"
+#include "Screen.h"
+#include "hal/Hal.h"
 #include "sensors/SensorInterface.h"
 
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
-Preferences prefs;
-WebServer server(80);
-HTTPClient http;
+static DisplayInterface& display = Hal::display();
+static StorageInterface& prefs = Hal::storage();
+static HttpInterface& http = Hal::http();
+static NetworkInterface& network = Hal::network();
 
-String sta_ssid = "";
-String sta_password = "";
-String device_id = "";
-String connectionStatus = "";
-String ap_password = "12345678";
-String reading_time = "15";
+char device_id[24] = "";
+const char* connectionStatus = "";
+static const char* apPassword = "12345678";
 
 // Device defaults
 static const char* deviceName = "DEVICE_NAME"; // Default device name
 static const char* devicePrefix = "XX";    // Default device prefix for ID generation
 static const char* measurementUnit = "units"; // Default measurement unit
-static String api_base_url = "https://ecomonitor-znv9.onrender.com/api"; // Default API base URL that device will send data to
+static const char* apiBaseUrl = "https://ecomonitor-znv9.onrender.com/api"; // Default API base URL that device will send data to
 
 bool screenEnabled = true;
+static bool displayReady = false;  // Duty-cycle wakes never start the display
 bool isConfigured = false;
-unsigned long lastReading = 0;
+static bool sleepMode = false;
+static unsigned long bootedAt = 0;
+static bool firstUploadLogged = false;
+
+// Wi-Fi state, driven by handleWiFi() from the loop; the event handler on the Wi-Fi task only sets the flags
+enum WiFiState { WIFI_OFF, WIFI_CONNECTING, WIFI_CONNECTED, WIFI_WAITING };
+static WiFiState wifiState = WIFI_OFF;
+static bool hintedAttempt = false;
+static bool everConnected = false;
+static unsigned long wifiStateSince = 0;
+static unsigned long wifiBackoff = WIFI_BACKOFF_MIN;
+static std::atomic<bool> stationUp(false);
+static std::atomic<bool> stationDown(false);
 unsigned long readingInterval = 0;
-unsigned long previousMillis = 0;
-const unsigned long displayReadingInterval = 5000;
+static ReportPolicy reportPolicy;
+static AlarmDetector alarmDetector;
+static unsigned long alarmSamplePeriod = 0;
+static unsigned long alarmUploadedAt = 0;
+static int sampleJob = -1;
+static int uploadJob = -1;
 
 void setDeviceName(const char* name) { deviceName = name; }
 void setDevicePrefix(const char* prefix) { devicePrefix = prefix; }
 void setMeasurementUnit(const char* unit) { measurementUnit = unit; }
-void setApiBaseUrl(const char* url) { api_base_url = url; }
+void setApiBaseUrl(const char* url) { apiBaseUrl = url; }
+void setAlarmSamplePeriod(unsigned long ms) { alarmSamplePeriod = ms; }
 
 const char* getDeviceName() { return deviceName; }
 const char* getDevicePrefix() { return devicePrefix; }
 const char* getMeasurementUnit() { return measurementUnit; }
-String getApiBaseUrl() { return api_base_url; }
+const char* getApiBaseUrl() { return Config::get().apiBaseUrl[0] ? Config::get().apiBaseUrl : apiBaseUrl; }
+
+// Free heap and largest free block, each with its lowest value since boot. Both stay flat once the upload
+// path has warmed up; a largest block that keeps shrinking means the heap is fragmenting.
+static void logHeapWatermarks() {
+    static uint32_t lowestLargestBlock = UINT32_MAX;
+    SystemInterface& system = Hal::system();
+    uint32_t largestBlock = system.largestFreeBlock();
+    if (largestBlock < lowestLargestBlock) lowestLargestBlock = largestBlock;
+    Serial.printf("Heap free %u (min %u), block %u (min %u)\n", (unsigned)system.freeHeap(),
+                  (unsigned)system.minFreeHeap(), (unsigned)largestBlock, (unsigned)lowestLargestBlock);
+}
+
+static void loadUploaderSettings() {
+    const DeviceConfig& config = Config::get();
+    Uploader::setBatchSize(config.batchSize);
+    Uploader::setBatchMaxAge(config.batchAgeMinutes * 60UL * 1000UL);
+    Uploader::setEncoding((PayloadEncoding)config.encoding);
+}
+
+// Access point of the last connection, so the next connect skips the channel scan
+static const StationHint* stationHint() {
+    const StationHint& hint = Config::get().stationHint;
+    return hint.channel != 0 ? &hint : nullptr;
+}
+
+static void saveStationHint() {
+    StationHint current;
+    memset(&current, 0, sizeof(current));
+    if (!network.stationHint(current)) return;
+    if (!WIFI_STATIC_IP) {
+        current.ip = current.gateway = current.subnet = current.dns = 0;
+    }
+    if (memcmp(&current, &Config::get().stationHint, sizeof(current)) == 0) return; // NVS is only written on a change
+    Config::edit().stationHint = current;
+}
+
+// Station only, without the display or the AP fallback; if it fails, the readings wait in the journal
+static bool connectForUpload() {
+    const DeviceConfig& config = Config::get();
+    unsigned long start = millis();
+    bool hinted = stationHint() != nullptr;
+    network.startStation(config.ssid, config.password, stationHint());
+    while (!network.isConnected() && millis() - start < SLEEP_WIFI_TIMEOUT) {
+        if (hinted && millis() - start >= WIFI_HINT_TIMEOUT) {
+            hinted = false; // The access point moved, scan for it
+            network.startStation(config.ssid, config.password);
+        }
+        delay(50);
+    }
+    if (!network.isConnected()) return false;
+    saveStationHint();
+    return true;
+}
+
+static void handleWake(unsigned long wakeStart);
+
+// Pending configuration changes are committed first
+static void restartDevice() {
+    Config::flush();
+    Hal::system().restart();
+}
+
+static bool restartPending = false;
+static unsigned long restartRequestedAt = 0;
+static unsigned long restartDelay = 0;
+
+// The settings are committed at once, the restart itself is left to housekeeping: the loop and the uploader
+// keep running while the message is on the screen
+static void scheduleRestart(unsigned long delayMs) {
+    Config::flush();
+    restartPending = true;
+    restartRequestedAt = millis();
+    restartDelay = delayMs;
+}
+
+static const char* wifiStateName() {
+    if (network.isAccessPoint()) return "ap";
+    switch (wifiState) {
+        case WIFI_CONNECTING: return "connecting";
+        case WIFI_CONNECTED: return "connected";
+        case WIFI_WAITING: return "waiting";
+        default: return "off";
+    }
+}
+
+// What the local HTTP API reports; the server task only ever sees this copy
+static void publishPortal(const Sample* sample) {
+    PortalSnapshot snapshot = {sample != nullptr, 0, 0, 0, wifiStateName(), connectionStatus,
+                               (uint16_t)EcoMonitor::journal.pending()};
+    if (sample) {
+        snapshot.value = sample->value;
+        snapshot.epoch = sample->epoch;
+        snapshot.sampledAt = sample->timestamp;
+    }
+    Portal::publish(snapshot);
+}
+
+// Credentials saved on the portal; the restart waits until the response page has reached the browser
+static void handlePortal() {
+    char ssid[33], password[65];
+    if (Portal::takeCredentials(ssid, sizeof(ssid), password, sizeof(password))) {
+        saveConfiguration(ssid, password);
+        displayMessage("Configuration", "saved", "Restarting...", "");
+        scheduleRestart(PORTAL_RESTART_DELAY);
+    }
+}
+
+// The value, what tripped the alarm and its level or rise, in place of the normal screen until it clears.
+// An alarm is shown even if the screen was disabled by command.
+static void displayAlarm(float value) {
+    if (!displayReady) return;
+
+    Screen& screen = EcoMonitor::screen;
+    char text[64];
+    snprintf(text, sizeof(text), "!! %s ALARM !!", getDeviceName());
+    screen.text(0, 0, 1, text);
+    screen.line(12);
+    snprintf(text, sizeof(text), "%.1f", value);
+    screen.text(0, 20, 2, text);
+    screen.text(Screen::textWidth(text, 2), 20, 1, getMeasurementUnit());
+    if (alarmDetector.cause() == CAUSE_RISE) {
+        snprintf(text, sizeof(text), "rising %.1f%s/min", alarmDetector.rise(), getMeasurementUnit());
+    } else {
+        snprintf(text, sizeof(text), "level %.1f%s", alarmDetector.level(), getMeasurementUnit());
+    }
+    screen.text(0, 44, 1, text);
+    screen.commit();
+}
+
+// A trip or clear is uploaded at once, with the summary of the interval so far; while the alarm stays on,
+// the server hears from the device every ALARM_REPEAT_INTERVAL
+static void checkAlarm(const Sample& sample, bool kept) {
+    AlarmEvent event = alarmDetector.check(sample);
+    bool repeat = alarmDetector.active() && millis() - alarmUploadedAt >= ALARM_REPEAT_INTERVAL;
+    if (event == ALARM_NO_CHANGE && !repeat) return;
+
+    if (!kept) EcoMonitor::sampler.keep(sample);
+    Reading reading = EcoMonitor::sampler.closeInterval();
+    reading.alarm = alarmDetector.active() ? ALARM_FLAG_RAISED : ALARM_FLAG_CLEARED;
+    sendDataToAPI(reading);
+    alarmUploadedAt = millis();
+    EcoMonitor::scheduler.runSoon(uploadJob);  // Without the uploader task, that job sends it
+    if (event == ALARM_NO_CHANGE) return;
+
+    Serial.printf("=== Alarm %s (%s): %.2f%s ===\n", event == ALARM_TRIPPED ? "tripped" : "cleared",
+                  AlarmDetector::causeName(event == ALARM_TRIPPED ? alarmDetector.cause() : CAUSE_NONE),
+                  sample.value, getMeasurementUnit());
+    if (!displayReady) return;
+    if (!screenEnabled) display.setPower(event == ALARM_TRIPPED);
+    if (event == ALARM_TRIPPED) displayAlarm(sample.value);
+    else displayData(EcoMonitor::sampler.latestChannels(), connectionStatus);
+}
+
+// Fast samples of the alarm rules only; they reach the history and the upload when they change the alarm
+static void handleAlarm() {
+    if (!alarmDetector.armed() || handleAPMode()) return;
+    checkAlarm(EcoMonitor::sampler.probe(), false);
+}
+
+// One reading per tick; the display and the log use the sampled value, the upload a summary of all of them
+static void handleSampling() {
+    if (handleAPMode()) return;
+
+    const Sample& sample = EcoMonitor::sampler.sample();
+    Serial.print("CO: "); Serial.print(sample.value,1);
+    Serial.println(getMeasurementUnit());
+    ApiStatus status = Uploader::status();
+    if (status != API_UNKNOWN) {
+        connectionStatus = status == API_ONLINE ? "Online" : "Offline";
+    }
+    if (alarmSamplePeriod == 0 && alarmDetector.armed()) {
+        checkAlarm(sample, true);
+    }
+    if (alarmDetector.active()) {
+        displayAlarm(sample.value);
+    } else {
+        displayData(EcoMonitor::sampler.latestChannels(), connectionStatus);
+    }
+    publishPortal(&sample);
+    LiveStream::publish(sample);
+
+    // Until the first connect of this boot is through, the samples only go into the interval summary
+    bool bootConnecting = !everConnected && wifiState == WIFI_CONNECTING;
+    ReportReason reason = bootConnecting ? REASON_NONE : reportPolicy.check(sample);
+    if (reason != REASON_NONE) {
+        sendDataToAPI(EcoMonitor::sampler.closeInterval());
+        Serial.printf("=== Sensor readings sent (%s) ===\n", ReportPolicy::reasonName(reason));
+        logHeapWatermarks();
+    }
+}
+
+// The instructions of the configuration AP; in station mode every sample redraws the screen itself
+static void handleDisplay() {
+    if (!handleAPMode()) return;
+    char ssidLine[32], ipLine[24], passwordLine[32];
+    snprintf(ssidLine, sizeof(ssidLine), "SSID: %s", getDeviceName());
+    snprintf(ipLine, sizeof(ipLine), "IP: %s", network.softAPIP().c_str());
+    snprintf(passwordLine, sizeof(passwordLine), "Password: %s", apPassword);
+    displayMessage("AP Mode Active", ssidLine, ipLine, passwordLine);
+}
+
+// Commands from the API responses and the MQTT channel are executed here, where the display and NVS are owned
+static void handleUploads() {
+    if (handleAPMode()) return;
+
+    ApiCommand command;
+    while (Uploader::nextCommand(command) || MqttChannel::nextCommand(command)) {
+        handleApiCommand(command.command, command.payload);
+    }
+
+    if (!Uploader::isTaskRunning()) {
+        Uploader::step();
+    }
+    if (MqttChannel::enabled() && !MqttChannel::isTaskRunning()) {
+        MqttChannel::step();
+    }
+
+    if (!firstUploadLogged && Uploader::firstUploadAt() != 0) {
+        firstUploadLogged = true;
+        EcoMonitor::bootToFirstUpload = Uploader::firstUploadAt() - bootedAt;
+        Serial.printf("Boot to first upload: %lu ms\n", EcoMonitor::bootToFirstUpload);
+    }
+}
+
+static void handleHousekeeping() {
+    handleWiFi();
+
+    // Everything the commands and the Wi-Fi changed since the last run goes to NVS in one write
+    Config::flush();
+
+    if (restartPending) {
+        if (millis() - restartRequestedAt >= restartDelay) restartDevice();
+        return;
+    }
+
+    // A cold boot in low-power mode stays awake for a while, then the device only wakes to sample
+    if (sleepMode && !handleAPMode() && millis() - bootedAt >= SLEEP_AWAKE_WINDOW && Uploader::idle()) {
+        // The samples since the last report are uploaded (or journaled) first, the wakes only buffer new ones
+        if (EcoMonitor::sampler.intervalSamples() > 0) {
+            sendDataToAPI(EcoMonitor::sampler.closeInterval());
+            EcoMonitor::scheduler.runSoon(uploadJob);
+            return;
+        }
+        Serial.println("Entering duty-cycle sleep");
+        if (displayReady) display.setPower(false);
+        DutyCycle::sleep(0);
+    }
+}
+
+// Periodic work of the main loop, all due at once after boot
+static void addLoopJobs() {
+    Scheduler& scheduler = EcoMonitor::scheduler;
+    scheduler.clear();
+    sampleJob = scheduler.add("sample", LOOP_SAMPLE_PERIOD, handleSampling);
+    scheduler.add("display", LOOP_DISPLAY_PERIOD, handleDisplay);
+    uploadJob = scheduler.add("upload", LOOP_UPLOAD_PERIOD, handleUploads);
+    scheduler.add("portal", LOOP_PORTAL_PERIOD, handlePortal);
+    scheduler.add("housekeeping", LOOP_HOUSEKEEPING_PERIOD, handleHousekeeping);
+    if (alarmSamplePeriod > 0) {
+        scheduler.add("alarm", alarmSamplePeriod, handleAlarm);
+    }
+}
 
 namespace EcoMonitor {
     SensorInterface *activeSensor = nullptr;
+    Sampler sampler;
+    Journal journal;
+    ConnectionStats connectionStats = {0, 0, 0};
+    unsigned long bootToFirstUpload = 0;
+    Screen screen(display);
+    Scheduler scheduler;
 
     void begin(SensorInterface* sensor) {
+        unsigned long wakeStart = micros();
         activeSensor = sensor;
+        activeSensor->begin();
+        sampler.begin(activeSensor);
+
+        prefs.begin("config");
+        Config::load();
+        const DeviceConfig& config = Config::get();
+        sleepMode = config.deepSleep;
+        if (sleepMode && DutyCycle::isWake() && config.configured) {
+            handleWake(wakeStart);
+            return;
+        }
+        bootedAt = millis();
+        firstUploadLogged = false;
+        restartPending = false;
         
         Serial.print(getDeviceName());
         Serial.println("Initializing...");
         
-        if(!display.begin(SSD1306_SWITCHCAPVCC, OLED_ADDR)) {
+        if(!display.begin()) {
             Serial.println(F("SSD1306 allocation failed"));
             Serial.println(F("Restarting in 5 seconds..."));
             delay(5000);
-            ESP.restart();
+            restartDevice();
         }
         
-        display.clearDisplay();
-        display.display();
+        displayReady = true;
+        screen.begin();
         Serial.println("Display initialized");
         
-        prefs.begin("config", false);
+        journal.begin();
         
         // Check configuration first
         checkConfiguration();
         
         // Generate device ID
-        device_id = generateDeviceID();
+        generateDeviceID(device_id, sizeof(device_id));
         
-        // Get saved values
-        api_base_url = prefs.getString("api_base_url", getApiBaseUrl());
-        reading_time = prefs.getString("reading_time", "15");
-        
-        int minutes = reading_time.toInt();
-        if (minutes <= 0 || minutes > 1440) {
-            minutes = 15;
-            reading_time = "15";
-            prefs.putString("reading_time", reading_time);
+        readingInterval = config.readingMinutes * 60UL * 1000UL;
+        reportPolicy.setHeartbeat(readingInterval);
+        reportPolicy.setDeadband(config.deadband);
+        reportPolicy.setRateBand(config.rateBand);
+        alarmDetector.reset();
+        alarmDetector.setLevel(config.alarmLevel);
+        alarmDetector.setHysteresis(config.alarmHysteresis);
+        alarmDetector.setRiseRate(config.alarmRise);
+        alarmUploadedAt = 0;
+
+        loadUploaderSettings();
+        // A sleeping device cannot hold the connection, its commands come with the upload responses
+        MqttChannel::begin(device_id, config.deepSleep ? "" : config.mqttBroker, config.mqttPort);
+        Uploader::begin();
+
+        // Samples of a duty-cycle wake that was followed by a restart are not lost
+        if (DutyCycle::buffered() > 0) {
+            sendDataToAPI(DutyCycle::closeBuffer());
         }
         
-        readingInterval = (unsigned long)minutes * 60UL * 1000UL;
-        
-        Serial.println("Device ID: " + device_id);
-        Serial.println("Reading interval: " + String(minutes) + " minutes");
+        Serial.printf("Device ID: %s\n", device_id);
+        Serial.printf("Reading interval: %u minutes\n", (unsigned)config.readingMinutes);
         
         // Show initial message
         displayMessage(getDeviceName() , "Device ID:", device_id, "Starting...");
-        delay(2000);
         
         // If configured, connect to Wi-Fi
         if (isConfigured) {
@@ -107,376 +418,363 @@ namespace EcoMonitor {
         } else {
             Serial.println("Device not configured, starting AP mode...");
             startAPMode();
-            setupWebServer();
+            Portal::begin(device_id, getApiBaseUrl(), true);
         }
+        addLoopJobs();
     }
 
     void handleLoop() {
-        server.handleClient();
-
-        if (handleAPMode()) return;
+        {
+            PROFILE_SCOPE(PROFILE_LOOP);
+            scheduler.runDue();
+        }
+        scheduler.sleep();
+    }
+}
 
-        unsigned long currentMillis = millis();
-        if (currentMillis - previousMillis >= displayReadingInterval) {
-            previousMillis = currentMillis;
-            float final_value = activeSensor->readSensor();
-            Serial.print("CO: "); Serial.print(final_value,1);
-            Serial.println(getMeasurementUnit());
-            displayData(final_value, connectionStatus);
+// Duty-cycle wake: one sample into RTC memory, Wi-Fi only once the buffer holds a reporting interval
+// or is full, or the value crossed the alarm level. The display and the web server stay off.
+static void handleWake(unsigned long wakeStart) {
+    const DeviceConfig& config = Config::get();
+    readingInterval = config.readingMinutes * 60UL * 1000UL;
+    size_t capacity = constrain(readingInterval / (SLEEP_SAMPLE_INTERVAL * 1000UL), 1UL, (unsigned long)SLEEP_BUFFER_SIZE);
+
+    const Sample& sample = EcoMonitor::sampler.sample();
+    size_t buffered = DutyCycle::add(sample);
+    bool alarm = DutyCycle::alarmChanged(sample.value, config.alarmLevel);
+    bool radio = alarm || buffered >= capacity || DutyCycle::bufferFull();
+
+    if (radio) {
+        EcoMonitor::journal.begin();
+        generateDeviceID(device_id, sizeof(device_id));
+        loadUploaderSettings();
+        Uploader::begin(false);
+
+        Reading reading = DutyCycle::closeBuffer();
+        if (alarm) reading.alarm = sample.value >= config.alarmLevel ? ALARM_FLAG_RAISED : ALARM_FLAG_CLEARED;
+        sendDataToAPI(reading);
+        if (connectForUpload()) {
+            Hal::clock().startTimeSync();
         }
+        Uploader::uploadNow();
 
-        if (lastReading == 0 || millis() - lastReading >= readingInterval) {
-            lastReading = millis();
-            float final_value = activeSensor->readSensor();
-            sendDataToAPI(final_value);
-            Serial.println("=== Sensor readings sent ===");
+        ApiCommand command;
+        while (Uploader::nextCommand(command)) {
+            handleApiCommand(command.command, command.payload);
         }
+        Config::flush();
     }
+
+    DutyCycle::endWake(micros() - wakeStart, radio);
+    DutyCycle::sleep(micros() - wakeStart);
 }
 
 
 void checkConfiguration() {
-    isConfigured = prefs.getBool("isConfigured");
-    if (isConfigured == true) {
-        sta_ssid = prefs.getString("sta_ssid");
-        sta_password = prefs.getString("sta_password");
-        reading_time = prefs.getString("reading_time");
-        
-        if (sta_ssid.length() > 0) {
-            prefs.putBool("isConfigured", true);
-            Serial.println("Device is configured");
-        } else {
-            prefs.putBool("isConfigured", false);
-        }
-    } else {
-        prefs.putBool("isConfigured", false);
+    isConfigured = Config::get().configured; // Config::load() already cleared it if the SSID is missing
+    if (isConfigured) {
+        Serial.println("Device is configured");
     }
 }
 
 void clearConfiguration() {
     prefs.clear();
-    prefs.putBool("isConfigured", false);
+    Config::reset();
+    Config::flush();
     Serial.println("Configuration cleared");
 }
-void saveConfiguration() {
-    prefs.putString("sta_ssid", sta_ssid);
-    prefs.putString("sta_password", sta_password);
-    prefs.putBool("isConfigured", true);
+void saveConfiguration(const char* ssid, const char* password) {
+    DeviceConfig& config = Config::edit();
+    strlcpy(config.ssid, ssid, sizeof(config.ssid));
+    strlcpy(config.password, password, sizeof(config.password));
+    memset(&config.stationHint, 0, sizeof(config.stationHint)); // New network, the cached access point is gone
+    config.configured = true;
+    Config::flush();
     Serial.println("Configuration saved to NVS");
 }
 void startAPMode() {
     Serial.println("Starting AP mode for configuration...");
-    WiFi.mode(WIFI_AP);
-    WiFi.softAP(getDeviceName(), ap_password);
+    network.startAccessPoint(getDeviceName(), apPassword);
 
     Serial.print("AP IP address: ");
-    Serial.println(WiFi.softAPIP());
+    Serial.println(network.softAPIP());
     Serial.print("AP SSID: ");
     Serial.println(getDeviceName());
 }
-void setupWebServer() {
-    server.on("/", HTTP_GET, []() {
-    String html = R"=====(
-    <!DOCTYPE html>
-    <html>
-    <head>
-        <title>WiFi Configuration</title>
-        <meta name="viewport" content="width=device-width, initial-scale=1">
-        <style>
-        body { font-family: Arial, sans-serif; margin: 40px; background-color: #f0f0f0; }
-        .container { max-width: 500px; margin: 0 auto; background: white; padding: 20px; border-radius: 10px; box-shadow: 0 0 10px rgba(0,0,0,0.1); }
-        h2 { color: #2c3e50; text-align: center; }
-        input[type="text"], input[type="password"] { 
-            width: 100%; padding: 12px; margin: 8px 0; 
-            border: 1px solid #ccc; border-radius: 4px; 
-            box-sizing: border-box;
-        }
-        input[type="submit"] { 
-            width: 100%; background-color: #3498db; 
-            color: white; padding: 14px; border: none; 
-            border-radius: 4px; cursor: pointer; 
-            font-size: 16px; margin-top: 10px;
-        }
-        input[type="submit"]:hover { background-color: #2980b9; }
-        label { font-weight: bold; color: #34495e; }
-        .device-info { background: #f8f9fa; padding: 15px; border-radius: 5px; margin-bottom: 15px; }
-        </style>
-    </head>
-    <body>
-        <div class="container">
-        <h2>=====" + getDeviceName() + R"=====( WiFi Setup</h2>
-        
-        <div class="device-info">
-            <strong>Device ID:</strong> )=====" + device_id + R"=====(<br>
-            <strong>API URL:</strong> )=====" + String(getApiBaseUrl()) + R"=====(<br>
-        </div>
-        
-        <form action="/configure" method="post">
-            <label for="ssid">WiFi Network Name:</label>
-            <input type="text" id="ssid" name="ssid" required placeholder="Enter your WiFi name">
-            
-            <label for="password">WiFi Password:</label>
-            <input type="password" id="password" name="password" placeholder="Enter your WiFi password">
-            
-            <input type="submit" value="Save & Connect">
-        </form>
-        </div>
-    </body>
-    </html>
-    )=====";
-    server.send(200, "text/html", html);
-    });
-
-    // After pressing 'Save & Connect' button
-    server.on("/configure", HTTP_POST, []() {
-    if (server.hasArg("ssid")) {
-        sta_ssid = server.arg("ssid");
-        sta_password = server.arg("password");
-        
-        saveConfiguration();
-        
-        // Send success response
-        String html = R"=====(
-        <!DOCTYPE html>
-        <html>
-        <head>
-        <title>Configuration Saved</title>
-        <meta name="viewport" content="width=device-width, initial-scale=1">
-        <style>
-            body { font-family: Arial, sans-serif; margin: 40px; text-align: center; background-color: #f0f0f0; }
-            .success { color: #27ae60; font-size: 24px; font-weight: bold; }
-            .container { max-width: 400px; margin: 0 auto; background: white; padding: 20px; border-radius: 10px; box-shadow: 0 0 10px rgba(0,0,0,0.1); }
-        </style>
-        </head>
-        <body>
-        <div class="container">
-            <div class="success">Configuration Saved!</div>
-            <p>Device will restart and connect in 5 seconds...</p>
-        </div>
-        <script>
-            setTimeout(function() {
-            window.location.href = "/";
-            }, 5000);
-        </script>
-        </body>
-        </html>
-        )=====";
-        
-        server.send(200, "text/html", html);
-        delay(5000);
-        ESP.restart();
-    } else {
-        server.send(400, "text/plain", "Error: Missing WiFi Name");
-    }
-    });
+// Wi-Fi task side, keep it short
+static void onStationEvent(StationEvent event) {
+    if (event == STATION_CONNECTED) stationUp = true;
+    else stationDown = true;
+}
 
-    server.begin();
-    Serial.println("HTTP server started");
+static void startStationAttempt(bool useHint) {
+    hintedAttempt = useHint && stationHint() != nullptr;
+    const DeviceConfig& config = Config::get();
+    network.startStation(config.ssid, config.password, hintedAttempt ? stationHint() : nullptr);
+    wifiState = WIFI_CONNECTING;
+    wifiStateSince = millis();
 }
+
+// Starts the connection and returns; handleWiFi() finishes it while the loop keeps sampling
 void connectToWiFi() {
-    sta_ssid = prefs.getString("sta_ssid", sta_ssid);
-    sta_password = prefs.getString("sta_password", sta_password);
     Serial.println("Connecting to saved WiFi...");
-    Serial.println("SSID: " + sta_ssid);
-
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(sta_ssid.c_str(), sta_password.c_str());
+    Serial.print("SSID: ");
+    Serial.println(Config::get().ssid);
+
+    network.onStationEvent(onStationEvent);
+    everConnected = false;
+    wifiBackoff = WIFI_BACKOFF_MIN;
+    connectionStatus = "Connecting";
+    startStationAttempt(true);
+}
 
-    int attempts = 0;
-    while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-        delay(500);
-        Serial.print(".");
-        attempts++;
+static void onWiFiConnected() {
+    Serial.printf("Connected to WiFi in %lu ms%s\n", millis() - wifiStateSince, hintedAttempt ? " (cached AP)" : "");
+    Serial.print("IP address: ");
+    Serial.println(network.localIP());
+    wifiState = WIFI_CONNECTED;
+    wifiBackoff = WIFI_BACKOFF_MIN;
+    saveStationHint();
+
+    if (!everConnected) {
+        everConnected = true;
+        char ipLine[24];
+        snprintf(ipLine, sizeof(ipLine), "IP: %s", network.localIP().c_str());
+        displayMessage("WiFi Connected!", ipLine, "Reading sensor...", "");
+
+        reportPolicy.reset();
+        EcoMonitor::scheduler.runSoon(sampleJob);
+        Hal::clock().startTimeSync();
+        Portal::begin(device_id, getApiBaseUrl(), false);
     }
+}
 
-    if (WiFi.status() == WL_CONNECTED) {
-        Serial.println("\nConnected to WiFi!");
-        Serial.print("IP address: ");
-        Serial.println(WiFi.localIP());
+// Connect timeouts, the AP fallback on boot and reconnects with exponential backoff after a drop
+void handleWiFi() {
+    if (stationUp.exchange(false) && (wifiState == WIFI_CONNECTING || wifiState == WIFI_WAITING)) {
+        onWiFiConnected();
+    }
+    if (stationDown.exchange(false) && wifiState == WIFI_CONNECTED) {
+        Serial.printf("WiFi lost, reconnecting in %lu ms\n", wifiBackoff);
+        wifiState = WIFI_WAITING;
+        wifiStateSince = millis();
+    }
 
-        displayMessage("WiFi Connected!", "IP: " + WiFi.localIP().toString(), "Reading sensor...", "");
-        delay(2000);
+    unsigned long elapsed = millis() - wifiStateSince;
+    if (wifiState == WIFI_CONNECTING && elapsed >= (hintedAttempt ? WIFI_HINT_TIMEOUT : WIFI_CONNECT_TIMEOUT)) {
+        if (hintedAttempt) {
+            Serial.println("Cached access point not found, scanning");
+            startStationAttempt(false);
+        } else if (!everConnected) {
+            Serial.println("Failed to connect to WiFi. Starting AP mode...");
+            displayMessage("WiFi Connection", "Failed!", "Starting AP mode...", "");
+            wifiState = WIFI_OFF;
+            startAPMode();
+            Portal::begin(device_id, getApiBaseUrl(), true);
+        } else {
+            Serial.printf("WiFi reconnect failed, next attempt in %lu ms\n", wifiBackoff);
+            wifiState = WIFI_WAITING;
+            wifiStateSince = millis();
+        }
+    } else if (wifiState == WIFI_WAITING && elapsed >= wifiBackoff) {
+        wifiBackoff = std::min(wifiBackoff * 2, (unsigned long)WIFI_BACKOFF_MAX);
+        startStationAttempt(true);
+    }
+}
 
-        lastReading = 0;
+void displayMessage(const char* line1, const char* line2, const char* line3, const char* line4) {
+    if (!screenEnabled || !displayReady) return;
 
-    } else {
-        Serial.println("\nFailed to connect to WiFi. Starting AP mode...");
-        displayMessage("WiFi Connection", "Failed!", "Starting AP mode...", "");
-        delay(2000);
-        startAPMode();
-        setupWebServer();
-    }
-}
-
-void displayMessage(String line1, String line2, String line3, String line4) {
-    if (!screenEnabled) return;
-
-    display.clearDisplay();
-    display.setTextSize(1);
-    display.setTextColor(WHITE);
-    display.setCursor(0,0);
-    display.println(line1);
-    display.setCursor(0,10);
-    display.println(line2);
-    display.setCursor(0,20);
-    display.println(line3);
-    display.setCursor(0,30);
-    display.println(line4);
-    display.display();
-}
-void handleApiCommand(String command, String payload) {
-    Serial.println("Executing command: " + command + " | Payload: " + payload);
-    if (command == "disable_screen") {
+    Screen& screen = EcoMonitor::screen;
+    screen.text(0, 0, 1, line1);
+    screen.text(0, 10, 1, line2);
+    screen.text(0, 20, 1, line3);
+    screen.text(0, 30, 1, line4);
+    screen.commit();
+}
+void handleApiCommand(const char* command, const char* payload) {
+    PROFILE_SCOPE(PROFILE_COMMAND);
+    Serial.printf("Executing command: %s | Payload: %s\n", command, payload);
+    if (strcmp(command, "disable_screen") == 0) {
         // Disable screen command
         screenEnabled = false; // Mark screen as disabled
-        display.ssd1306_command(SSD1306_DISPLAYOFF); // Disable screen using Adafruit library
+        if (displayReady) display.setPower(false); // Disable screen
         Serial.println("Screen disabled by command");
     }
-    else if (command == "enable_screen") {
+    else if (strcmp(command, "enable_screen") == 0) {
         // Enable screen command
         screenEnabled = true; // Mark screen as enabled
-        display.ssd1306_command(SSD1306_DISPLAYON); // Enable screen using Adafruit library
+        if (displayReady) display.setPower(true); // Enable screen
         Serial.println("Screen enabled by command");
     }
-    else if (command == "reboot") {
+    else if (strcmp(command, "reboot") == 0) {
         // Reboot ESP command
         displayMessage("Rebooting...", "", "", "");
-        delay(2000);
-        ESP.restart(); // Restart ESP
+        scheduleRestart(COMMAND_RESTART_DELAY);
     }
-    else if (command == "change_reading_time") {
+    else if (strcmp(command, "change_reading_time") == 0) {
         // This command updates the reading interval using the value provided in the payload
-        prefs.putString("reading_time", payload); // Save new interval to NVS
-        displayMessage("Reading time", "changed to " + payload + "m", "Restarting...", "");
-        delay(2000);
-        ESP.restart(); // ESP m
+        long minutes = atol(payload);
+        if (minutes > 0 && minutes <= 1440) {
+            Config::edit().readingMinutes = minutes; // Saved to NVS before the restart
+            char changedLine[24];
+            snprintf(changedLine, sizeof(changedLine), "changed to %ldm", minutes);
+            displayMessage("Reading time", changedLine, "Restarting...", "");
+            scheduleRestart(COMMAND_RESTART_DELAY);
+        }
+    }
+    else if (strcmp(command, "change_batch_size") == 0) {
+        // Number of readings sent together in one request, 1 disables batching
+        unsigned long batchSize = constrain(atol(payload), 1, UPLOAD_BATCH_MAX);
+        Uploader::setBatchSize(batchSize);
+        Config::edit().batchSize = batchSize;
+        Serial.printf("Batch size changed to %lu\n", batchSize);
+    }
+    else if (strcmp(command, "change_batch_age") == 0) {
+        // Longest time in minutes a reading may wait for its batch to fill up
+        long minutes = atol(payload);
+        if (minutes > 0 && minutes <= 1440) {
+            Uploader::setBatchMaxAge((unsigned long)minutes * 60UL * 1000UL);
+            Config::edit().batchAgeMinutes = minutes;
+            Serial.printf("Batch age changed to %ldm\n", minutes);
+        }
+    }
+    else if (strcmp(command, "change_deadband") == 0 || strcmp(command, "change_rate_band") == 0) {
+        // Change-driven uploads: deadband in the unit of the measurement, rate band in units per minute, 0 turns it off
+        float band = atof(payload);
+        if (band >= 0) {
+            bool deadband = strcmp(command, "change_deadband") == 0;
+            if (deadband) reportPolicy.setDeadband(band);
+            else reportPolicy.setRateBand(band);
+            DeviceConfig& config = Config::edit();
+            (deadband ? config.deadband : config.rateBand) = band;
+            Serial.printf("%s changed to %s\n", deadband ? "Deadband" : "Rate band", payload);
+        }
+    }
+    else if (strcmp(command, "change_encoding") == 0) {
+        // "msgpack" sends the readings as MessagePack, "json" goes back to JSON
+        PayloadEncoding encoding;
+        if (Payload::encodingFromName(payload, encoding)) {
+            Uploader::setEncoding(encoding);
+            Config::edit().encoding = encoding;
+            Serial.printf("Upload encoding changed to %s\n", payload);
+        }
+    }
+    else if (strcmp(command, "change_deep_sleep") == 0) {
+        // "1" sleeps between samples (battery units), "0" stays awake; takes effect after the restart
+        bool enabled = atoi(payload) != 0;
+        Config::edit().deepSleep = enabled;
+        displayMessage("Deep sleep", enabled ? "on" : "off", "Restarting...", "");
+        scheduleRestart(COMMAND_RESTART_DELAY);
+    }
+    else if (strcmp(command, "change_alarm_level") == 0) {
+        // Reaching it raises the alarm, and duty-cycle wakes bring Wi-Fi up at once when the value crosses it;
+        // 0 turns it off
+        float level = atof(payload);
+        if (level >= 0) {
+            alarmDetector.setLevel(level);
+            Config::edit().alarmLevel = level;
+            Serial.printf("Alarm level changed to %s\n", payload);
+        }
+    }
+    else if (strcmp(command, "change_alarm_hysteresis") == 0 || strcmp(command, "change_alarm_rise") == 0) {
+        // Units below the level that clear the alarm, and the rise in units per minute that trips it (0: off)
+        float value = atof(payload);
+        if (value >= 0) {
+            bool hysteresis = strcmp(command, "change_alarm_hysteresis") == 0;
+            if (hysteresis) alarmDetector.setHysteresis(value);
+            else alarmDetector.setRiseRate(value);
+            DeviceConfig& config = Config::edit();
+            (hysteresis ? config.alarmHysteresis : config.alarmRise) = value;
+            Serial.printf("Alarm %s changed to %s\n", hysteresis ? "hysteresis" : "rise", payload);
+        }
+    }
+    else if (strcmp(command, "change_mqtt_broker") == 0) {
+        // "host[:port]" of the broker that pushes commands, empty turns the channel off; takes effect after the restart
+        char broker[sizeof(DeviceConfig::mqttBroker)];
+        strlcpy(broker, payload, sizeof(broker));
+        char* port = strchr(broker, ':');
+        if (port) *port++ = '\0';
+        DeviceConfig& config = Config::edit();
+        strlcpy(config.mqttBroker, broker, sizeof(config.mqttBroker));
+        config.mqttPort = port && atoi(port) > 0 ? atoi(port) : MQTT_PORT;
+        displayMessage("MQTT broker", broker[0] ? broker : "off", "Restarting...", "");
+        scheduleRestart(COMMAND_RESTART_DELAY);
+    }
+    else if (strcmp(command, "dump_metrics") == 0) {
+        // Latency histograms, heap and stack gauges over serial, the same text as GET /metrics
+        Profiler::dump();
     }
-    else if (command == "factory_reset") {
+    else if (strcmp(command, "factory_reset") == 0) {
         // Function for clearing the ESP NVS
         clearConfiguration();
         displayMessage("Factory Reset", "Restarting...", "", "");
-        delay(2000);
-        ESP.restart(); // Restart ESP
+        scheduleRestart(COMMAND_RESTART_DELAY);
     }
     else {
-        Serial.println("Unknown command: " + command);
+        Serial.printf("Unknown command: %s\n", command);
     }
 }
 
-String generateDeviceID() {
-    String id = getDevicePrefix(); // e.g., "GG-"
-    id += String((uint32_t)ESP.getEfuseMac(), HEX); // *This function gets only the last 32 bits of MAC address, so in very rare situations the ID's may repeat
-    id.toUpperCase();
-    return id;
+void generateDeviceID(char* id, size_t size) {
+    // Prefix e.g. "GG-" followed by the MAC address in hex
+    // *This function gets only the last 32 bits of MAC address, so in very rare situations the ID's may repeat
+    snprintf(id, size, "%s%lX", getDevicePrefix(), (unsigned long)(uint32_t)Hal::system().efuseMac());
 }
 
-void displayData(float final_value, String connectionStatus) {
-    if (!screenEnabled) return;
+void displayData(const SensorReading& reading, const char* connectionStatus) {
+    if (!screenEnabled || !displayReady) return;
+    float final_value = reading.channels[0].value;
 
-        display.clearDisplay();
-        display.setTextSize(1);
-        display.setCursor(0,0);
+    Screen& screen = EcoMonitor::screen;
+    char text[64];  // Cut to SCREEN_FIELD_LENGTH by the screen
 
     // Header
-    if (WiFi.getMode() == WIFI_MODE_AP) {
-        display.print(getDeviceName());
-        display.println(" - AP Mode");
+    if (network.isAccessPoint()) {
+        snprintf(text, sizeof(text), "%s - AP Mode", getDeviceName());
     } else {
-        display.print(device_id);
-        display.print(" - ");
-        display.println(connectionStatus);
+        snprintf(text, sizeof(text), "%s - %s", device_id, connectionStatus);
     }
-        display.drawLine(0, 12, 128, 12, WHITE);
+    screen.text(0, 0, 1, text);
+    screen.line(12);
 
-        display.setCursor(0,20);
-        display.setTextSize(2);
     if (final_value < 0.01) {
-        display.print("<0.01");
-    } else if (final_value < 1.0) {
-        display.print(final_value, 3);
-    } else if (final_value < 10.0) {
-        display.print(final_value, 2);
+        snprintf(text, sizeof(text), "<0.01");
     } else {
-        display.print(final_value, 1);
+        snprintf(text, sizeof(text), "%.*f", final_value < 1.0 ? 3 : final_value < 10.0 ? 2 : 1, final_value);
     }
-    display.setTextSize(1);
-    display.println(getMeasurementUnit());
+    screen.text(0, 20, 2, text);
+    screen.text(Screen::textWidth(text, 2), 20, 1, getMeasurementUnit());
 
-    display.display();
-}
-
-void sendDataToAPI(float final_value) {
-    if (WiFi.status() != WL_CONNECTED) {
-        Serial.println("Cannot send data - Wi-Fi not connected");
-        connectionStatus = "Offline"; // Connection status is offline when can not connect to the API but Wi-Fi
-        return;
+    // Further channels, one line each below the main value
+    for (uint8_t i = 1; i < reading.count; i++) {
+        snprintf(text, sizeof(text), "%.1f%s", reading.channels[i].value, channelUnit(reading.channels[i].id));
+        screen.text(0, 30 + i * 10, 1, text);
     }
+    screen.commit();
+}
 
-    String url = String(getApiBaseUrl()) + "/sensor-readings/";
-    Serial.println("Sending to: " + url);
-
-    JsonDocument doc;
-    doc["device_id"] = device_id;
-    doc["final_value"] = final_value;
-
-    String payload;
-    serializeJson(doc, payload);
-    Serial.println("Payload: " + payload);
-
-    http.begin(url);
-    http.addHeader("Content-Type", "application/json");
-    http.setTimeout(10000);
-
-    Serial.println("Sending POST request...");
-    int httpCode = http.POST(payload);
-
-    if (httpCode > 0) {
-        String response = http.getString();
-        Serial.println("HTTP Code: " + String(httpCode) + ", Response: " + response);
-        connectionStatus = "Online";
-
-        if (response.length() > 2) {
-            JsonDocument resDoc;
-            DeserializationError error = deserializeJson(resDoc, response);
-
-            if (!error && resDoc["command"].is<String>()) {
-                // If command found in response
-                String command = resDoc["command"];
-                String payload = resDoc["payload"] | "";
-                Serial.println("Found command in response: " + command);
-                handleApiCommand(command, payload);
-            }
-        }
-    } else {
-        Serial.println("HTTP POST failed: " + http.errorToString(httpCode));
-        connectionStatus = "Offline";
+// Hands the reading to the uploader task; the upload itself never runs on the main loop
+void sendDataToAPI(const Reading& reading) {
+    if (!Uploader::enqueue(reading)) {
+        Serial.println("Upload queue full, reading dropped");
     }
-
-    http.end();
 }
 
 bool handleAPMode() {
-    bool isConfig = prefs.getBool("isConfigured", false);  // Use different name
+    bool isConfig = Config::get().configured;
 
-    if (WiFi.getMode() == WIFI_STA && WiFi.status() == WL_CONNECTED) {
+    if (network.isStation() && network.isConnected()) {
         return false;
     }
 
     if (!isConfig) {
-        static unsigned long lastDisplayUpdate = 0;
-        if (millis() - lastDisplayUpdate > 2000) {
-            lastDisplayUpdate = millis();
-            displayMessage("AP Mode Active", 
-                          String("SSID: ") + String(getDeviceName()),
-                          "IP: " + WiFi.softAPIP().toString(), 
-                          "Password: " + ap_password);
-        }
-        
         // Only start AP and server once
         static bool apStarted = false;
         if (!apStarted) {
             startAPMode();
-            setupWebServer();
+            Portal::begin(device_id, getApiBaseUrl(), true);
+            publishPortal(nullptr);
             apStarted = true;
             Serial.println("AP Mode started for configuration");
         }
@@ -1,62 +1,96 @@
 #ifndef ECOMONITOR_ECOMONITOR_H
 #define ECOMONITOR_ECOMONITOR_H
 
+#include <Arduino.h>
+
+#include "Sampler.h"
+#include "Journal.h"
+#include "Uploader.h"
+
 void setDeviceName(const char* name);
 void setDevicePrefix(const char* prefix);
 void setMeasurementUnit(const char* unit);
 void setApiBaseUrl(const char* url);
+void setAlarmSamplePeriod(unsigned long ms);   // Fast alarm samples (Alarm.h) for a sensor that reads quickly, 0: off
 
 extern const char* getDeviceName();
 extern const char* getDevicePrefix();
 extern const char* getMeasurementUnit();
-String getApiBaseUrl();
+const char* getApiBaseUrl();
 
-#include <Arduino.h>
-#include <Preferences.h>
-#include <Wire.h>
-#include <WebServer.h>
-#include <HTTPClient.h>
-
-class Preferences;
-class Adafruit_SSD1306;
-class WebServer;
-class HTTPClient;
 class SensorInterface;
+class Screen;
+class Scheduler;
 
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 #define OLED_ADDR 0x3C
 #define OLED_SDA 21
 #define OLED_SCL 22
+#ifndef OLED_I2C_CLOCK
+#define OLED_I2C_CLOCK 400000   // Hz while the display is written, the SSD1306 is specified up to 400 kHz
+#endif
+#ifndef I2C_BUS_CLOCK
+#define I2C_BUS_CLOCK 100000    // Hz the rest of the time, the AM2320 on the same bus only supports 100 kHz
+#endif
+
+// Wi-Fi connect and reconnect
+#define WIFI_CONNECT_TIMEOUT 10000  // ms one attempt with a channel scan may take
+#define WIFI_HINT_TIMEOUT 3000      // ms an attempt straight to the cached access point may take
+#define WIFI_BACKOFF_MIN 1000       // ms before reconnecting after a drop, doubled after every failed attempt
+#define WIFI_BACKOFF_MAX 60000
+#ifndef WIFI_STATIC_IP
+#define WIFI_STATIC_IP 0            // 1: reuse the last DHCP lease as a static address, saves DHCP on every connect
+#endif
+
+// Jobs of the main loop, periods in ms (see Scheduler.h)
+#define LOOP_SAMPLE_PERIOD 5000         // Sample, display, local API and the reporting policy
+#define LOOP_DISPLAY_PERIOD 2000        // Instructions on the screen in AP mode
+#define LOOP_UPLOAD_PERIOD UPLOADER_PERIOD  // API commands, and the uploader itself when it has no task
+#define LOOP_PORTAL_PERIOD 100          // Credentials saved on the portal
+#define LOOP_HOUSEKEEPING_PERIOD 100    // Wi-Fi state, NVS flush, pending restarts and the deep-sleep entry
+#define COMMAND_RESTART_DELAY 2000      // ms the message of a command that restarts the device stays on the screen
+
+struct ConnectionStats {
+    unsigned long fresh;         // Requests that had to open a new connection (TCP + TLS handshake)
+    unsigned long reused;        // Requests sent over a kept-alive connection
+    unsigned long staleRetries;  // Kept-alive connections the server had closed in the meantime
+};
 
 namespace EcoMonitor {
     extern SensorInterface *activeSensor;
+    extern Sampler sampler;
+    extern Journal journal;
+    extern ConnectionStats connectionStats;
+    extern unsigned long bootToFirstUpload;  // ms from begin() to the first delivered upload, 0 until then
+    extern Screen screen;
+    extern Scheduler scheduler;
     
     void begin(SensorInterface* sensor);
-    void handleLoop();   
+    void handleLoop();   // Runs the jobs that are due, then sleeps until the next deadline
 }
 
 // Configuration
 void checkConfiguration();
-void saveConfiguration();
+void saveConfiguration(const char* ssid, const char* password);
 void clearConfiguration();
 
 // Display
-void displayMessage(String line1 = "", String line2 = "", String line3 = "", String line4 = "");
-void displayData(float final_value, String connectionStatus);
+void displayMessage(const char* line1 = "", const char* line2 = "", const char* line3 = "", const char* line4 = "");
+void displayData(const SensorReading& reading, const char* connectionStatus);
 
 // Sensor
 float readSensor();
 
 // WiFi and Webserver
-void setupWebServer();
 void startAPMode();
 bool handleAPMode();
 void connectToWiFi();
-void handleApiCommand(String command, String payload);
-void sendDataToAPI(float final_value);
+void handleWiFi();
+void handleApiCommand(const char* command, const char* payload);
+void sendDataToAPI(const Reading& reading);
 
 // Device ID
-String generateDeviceID();
+void generateDeviceID(char* id, size_t size);
 
 #endif
\ No newline at end of file
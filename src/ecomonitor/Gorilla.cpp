@@ -0,0 +1,201 @@
+/*
+ * File: Gorilla.cpp
+ * Description: Time-series block compression, see Gorilla.h.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <string.h>
+
+#include "Gorilla.h"
+
+// Ranges of the difference of deltas: prefix, prefix length and payload bits; anything else is '1111' + 32 bits
+struct DeltaBucket {
+    uint8_t prefix;
+    uint8_t prefixBits;
+    uint8_t bits;
+};
+static const DeltaBucket deltaBuckets[] = {{0b10, 2, 7}, {0b110, 3, 9}, {0b1110, 4, 12}};
+
+static uint32_t floatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bitsFloat(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void putLittleEndian(uint8_t* out, uint32_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) out[i] = value >> (8 * i);
+}
+
+static uint32_t getLittleEndian(const uint8_t* in, size_t bytes) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes; i++) value |= (uint32_t)in[i] << (8 * i);
+    return value;
+}
+
+// Bit stream after the header, filled most significant bit first
+class BitWriter {
+public:
+    BitWriter(uint8_t* stream, size_t size, uint32_t position) : limit(size * 8), position(position), stream(stream) {}
+
+    void write(uint32_t value, uint8_t bits) {
+        if (position + bits > limit) {
+            overflow = true;
+            return;
+        }
+        while (bits > 0) {
+            uint8_t& byte = stream[position / 8];
+            uint8_t free = 8 - position % 8;
+            uint8_t n = bits < free ? bits : free;
+            uint8_t chunk = (value >> (bits - n)) & ((1u << n) - 1);
+            uint8_t shift = free - n;
+            byte = (byte & ~(((1u << n) - 1) << shift)) | (chunk << shift);
+            position += n;
+            bits -= n;
+        }
+    }
+
+    uint32_t limit;
+    uint32_t position;
+    bool overflow = false;
+
+private:
+    uint8_t* stream;
+};
+
+namespace Gorilla {
+    bool append(GorillaState& state, uint8_t* block, size_t size, uint32_t epoch, float value) {
+        uint32_t bits = floatBits(value);
+        if (state.count == 0) {
+            if (size < GORILLA_HEADER_SIZE) return false;
+            putLittleEndian(block, 1, 2);
+            putLittleEndian(block + 2, epoch, 4);
+            putLittleEndian(block + 6, bits, 4);
+            state = {1, 0, epoch, 0, bits, 0, 0xFF};
+            return true;
+        }
+        if (state.count == UINT16_MAX) return false;
+
+        BitWriter out(block + GORILLA_HEADER_SIZE, size - GORILLA_HEADER_SIZE, state.bits);
+        GorillaState next = state;
+
+        // Unsigned arithmetic, so clock jumps of any size wrap the same way in the reader
+        uint32_t delta = epoch - state.epoch;
+        int32_t dod = (int32_t)(delta - state.delta);
+        if (dod == 0) {
+            out.write(0, 1);
+        } else {
+            bool written = false;
+            for (const DeltaBucket& bucket : deltaBuckets) {
+                int32_t half = 1 << (bucket.bits - 1);
+                if (dod >= -(half - 1) && dod <= half) {
+                    out.write(bucket.prefix, bucket.prefixBits);
+                    out.write(dod + half - 1, bucket.bits);
+                    written = true;
+                    break;
+                }
+            }
+            if (!written) {
+                out.write(0b1111, 4);
+                out.write((uint32_t)dod, 32);
+            }
+        }
+
+        uint32_t xored = bits ^ state.value;
+        if (xored == 0) {
+            out.write(0, 1);
+        } else {
+            uint8_t leading = __builtin_clz(xored);
+            uint8_t trailing = __builtin_ctz(xored);
+            if (state.trailing != 0xFF && leading >= state.leading && trailing >= state.trailing) {
+                // Fits the previous window, only the bits inside it
+                out.write(0b10, 2);
+                out.write(xored >> state.trailing, 32 - state.leading - state.trailing);
+            } else {
+                uint8_t meaningful = 32 - leading - trailing;
+                out.write(0b11, 2);
+                out.write(leading, 5);
+                out.write(meaningful - 1, 5);
+                out.write(xored >> trailing, meaningful);
+                next.leading = leading;
+                next.trailing = trailing;
+            }
+        }
+        if (out.overflow) return false;
+
+        next.count++;
+        next.bits = out.position;
+        next.epoch = epoch;
+        next.delta = delta;
+        next.value = bits;
+        state = next;
+        putLittleEndian(block, state.count, 2);
+        return true;
+    }
+}
+
+GorillaReader::GorillaReader(const uint8_t* block, size_t length) : block(block), length(length) {
+    if (length >= GORILLA_HEADER_SIZE) total = getLittleEndian(block, 2);
+}
+
+bool GorillaReader::next(uint32_t& epoch, float& value) {
+    if (index >= total || truncated) return false;
+    if (index == 0) {
+        state.epoch = getLittleEndian(block + 2, 4);
+        state.value = getLittleEndian(block + 6, 4);
+        state.trailing = 0xFF;
+    } else {
+        int32_t dod = 0;
+        if (readBit()) {
+            uint8_t bucket = 0;
+            while (bucket < 3 && readBit()) bucket++;
+            if (bucket < 3) {
+                int32_t half = 1 << (deltaBuckets[bucket].bits - 1);
+                dod = (int32_t)read(deltaBuckets[bucket].bits) - (half - 1);
+            } else {
+                dod = (int32_t)read(32);
+            }
+        }
+        state.delta += (uint32_t)dod;
+        state.epoch += state.delta;
+
+        if (readBit()) {
+            if (readBit()) {
+                uint8_t leading = read(5);
+                uint8_t meaningful = read(5) + 1;
+                if (leading + meaningful > 32) truncated = true;   // Not something append() writes
+                state.leading = leading;
+                state.trailing = 32 - leading - meaningful;
+            } else if (state.trailing == 0xFF) {
+                truncated = true;
+            }
+            if (truncated) return false;
+            state.value ^= read(32 - state.leading - state.trailing) << state.trailing;
+        }
+        if (truncated) return false;
+    }
+    index++;
+    epoch = state.epoch;
+    value = bitsFloat(state.value);
+    return true;
+}
+
+uint32_t GorillaReader::read(uint8_t bits) {
+    uint32_t value = 0;
+    const uint8_t* stream = block + GORILLA_HEADER_SIZE;
+    size_t limit = (length - GORILLA_HEADER_SIZE) * 8;
+    if (position + bits > limit) {
+        truncated = true;
+        return 0;
+    }
+    for (uint8_t i = 0; i < bits; i++, position++) {
+        value = (value << 1) | ((stream[position / 8] >> (7 - position % 8)) & 1);
+    }
+    return value;
+}
@@ -0,0 +1,85 @@
+/*
+ * File: Gorilla.h
+ * Description: Streaming compression of (epoch, value) series after Facebook's Gorilla: timestamps are stored as
+ *              the difference of their deltas, so a fixed sampling interval costs one bit, and each float as the
+ *              XOR with the previous one, so a repeated value costs one bit and a small step (a 0.0625 °C DS18B20
+ *              step) only its changed mantissa bits. Points go into a fixed-size block that is self-contained:
+ *              a 10-byte header (count, first epoch, first value, little endian) followed by the bit stream, most
+ *              significant bit first. data()/length() can be written to flash or sent as a request body as they are.
+ *              GorillaBlock keeps all its state inline and is valid when zeroed, so it can live in RTC memory.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_GORILLA_H
+#define ECOMONITOR_GORILLA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define GORILLA_HEADER_SIZE 10      // Count (2), first epoch (4), first value (4)
+#define GORILLA_MAX_POINT_BITS 80   // Worst case after the first point: 36 bits of timestamp, 44 of value
+
+// Encoder position; zero is an empty block
+struct GorillaState {
+    uint16_t count;
+    uint32_t bits;                  // Bits used after the header
+    uint32_t epoch;
+    uint32_t delta;                 // Previous delta, modulo 2^32 like the difference of deltas
+    uint32_t value;                 // Previous value's bits
+    uint8_t leading;                // Window of the previous XOR, not set while trailing is 0xFF
+    uint8_t trailing;
+};
+
+namespace Gorilla {
+    // Appends one point to the block of size bytes; false (block unchanged) if it does not fit
+    bool append(GorillaState& state, uint8_t* block, size_t size, uint32_t epoch, float value);
+    inline size_t length(const GorillaState& state) {
+        return state.count == 0 ? 0 : GORILLA_HEADER_SIZE + (state.bits + 7) / 8;
+    }
+}
+
+// Points of a block oldest first
+class GorillaReader {
+public:
+    GorillaReader(const uint8_t* block, size_t length);
+    uint16_t count() const { return total; }
+    bool next(uint32_t& epoch, float& value);   // False after the last point or on a truncated or damaged block
+
+private:
+    uint32_t read(uint8_t bits);
+    bool readBit() { return read(1) != 0; }
+
+    const uint8_t* block;
+    size_t length;
+    uint16_t total = 0;
+    uint16_t index = 0;
+    uint32_t position = 0;          // Bit position after the header
+    bool truncated = false;
+    GorillaState state = {};
+};
+
+template <size_t N>
+class GorillaBlock {
+    static_assert(N > GORILLA_HEADER_SIZE, "a block holds at least its header");
+
+public:
+    void clear() { state = {}; }
+    bool append(uint32_t epoch, float value) { return Gorilla::append(state, bytes, N, epoch, value); }
+
+    // No room left for a worst-case point
+    bool isFull() const { return state.count > 0 && (N - GORILLA_HEADER_SIZE) * 8 - state.bits < GORILLA_MAX_POINT_BITS; }
+    size_t size() const { return state.count; }
+    const uint8_t* data() const { return bytes; }
+    size_t length() const { return Gorilla::length(state); }
+    GorillaReader reader() const { return GorillaReader(bytes, length()); }
+    static size_t capacity() { return N; }
+
+private:
+    uint8_t bytes[N];
+    GorillaState state;
+};
+
+#endif
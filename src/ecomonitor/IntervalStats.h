@@ -0,0 +1,53 @@
+/*
+ * File: IntervalStats.h
+ * Description: Streaming summary of the samples of one reporting interval: count, min, max, mean and standard
+ *              deviation, updated with Welford's method, so it needs constant memory however many samples the
+ *              interval has and stays accurate without keeping a running sum of squares.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_INTERVAL_STATS_H
+#define ECOMONITOR_INTERVAL_STATS_H
+
+#include <math.h>
+#include <stdint.h>
+
+class IntervalStats {
+public:
+    void add(float value) {
+        if (!isfinite(value)) {
+            // A failed sensor read (NAN) would stay in the mean, deviation and extremes for the whole interval
+            if (skippedCount < UINT16_MAX) skippedCount++;
+            return;
+        }
+        if (count == UINT16_MAX) return;
+        count++;
+        float delta = value - runningMean;
+        runningMean += delta / count;
+        m2 += delta * (value - runningMean);
+        if (count == 1 || value < minimum) minimum = value;
+        if (count == 1 || value > maximum) maximum = value;
+    }
+
+    void reset() { *this = IntervalStats(); }
+
+    uint16_t samples() const { return count; }
+    uint16_t skipped() const { return skippedCount; }   // Non-finite values left out
+    float min() const { return minimum; }
+    float max() const { return maximum; }
+    float mean() const { return runningMean; }
+    float stddev() const { return count > 1 ? sqrtf(m2 / count) : 0.0f; } // Population deviation of the interval
+
+private:
+    uint16_t count = 0;
+    uint16_t skippedCount = 0;
+    float runningMean = 0;
+    float m2 = 0;       // Sum of squared differences from the mean
+    float minimum = 0;
+    float maximum = 0;
+};
+
+#endif
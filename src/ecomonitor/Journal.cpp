@@ -0,0 +1,169 @@
+/*
+ * File: Journal.cpp
+ * Description: Store-and-forward journal, see Journal.h.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include "Journal.h"
+#include "hal/Hal.h"
+
+static const char* ackKey = "journal_ack"; // Sequence of the oldest pending record
+
+static uint32_t crc32(const uint8_t* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint16_t recordCrc(const JournalRecord& record) {
+    return (uint16_t)crc32((const uint8_t*)&record, offsetof(JournalRecord, crc));
+}
+
+static size_t slotOffset(uint32_t sequence) {
+    return (size_t)(sequence % JOURNAL_CAPACITY) * sizeof(JournalRecord);
+}
+
+bool Journal::begin() {
+    BlockStoreInterface& store = Hal::blockStore();
+    ready = store.begin(JOURNAL_CAPACITY * sizeof(JournalRecord));
+    sectorRecords = store.sectorSize() / sizeof(JournalRecord);
+    if (ready && (sectorRecords == 0 || JOURNAL_CAPACITY % sectorRecords != 0)) {
+        Serial.println("Journal capacity is not a whole number of flash sectors");
+        ready = false;
+    }
+    if (!ready) {
+        Serial.println("Journal unavailable - offline readings will not be kept");
+        return false;
+    }
+
+    // The newest valid record tells where appending continues
+    uint32_t newest = 0;
+    for (uint32_t slot = 0; slot < JOURNAL_CAPACITY; slot++) {
+        JournalRecord record;
+        if (store.read(slot * sizeof(JournalRecord), &record, sizeof(record))
+            && record.sequence != 0 && record.crc == recordCrc(record) && record.sequence > newest) {
+            newest = record.sequence;
+        }
+    }
+    nextSequence = newest + 1;
+
+    // A torn write (or a partition that was never erased) leaves slots that are neither valid nor blank;
+    // appending continues after them, at the latest with the next sector, which is erased first
+    while (nextSequence % sectorRecords != 0 && !slotErased(nextSequence)) nextSequence++;
+
+    // No saved position (first boot or factory reset) means nothing is pending
+    oldestSequence = Hal::storage().getUInt(ackKey, nextSequence);
+    if (oldestSequence > nextSequence) oldestSequence = nextSequence; // Partition was erased
+    if (oldestSequence < oldestKept()) oldestSequence = oldestKept();
+
+    Serial.printf("Journal: %u readings pending\n", (unsigned)pending());
+    return true;
+}
+
+void Journal::append(const Reading& reading) {
+    if (!ready) return;
+
+    // First reading of an outage: remember where the backlog starts
+    if (pending() == 0) {
+        saveAck();
+    }
+
+    JournalRecord record;
+    record.sequence = nextSequence;
+    record.epoch = reading.epoch;
+    record.value = reading.value;
+    record.min = reading.min;
+    record.max = reading.max;
+    record.mean = reading.mean;
+    record.stddev = reading.stddev;
+    record.count = reading.count;
+    record.crc = recordCrc(record);
+
+    // First record of a sector in this lap: erase it, which takes the records of the last lap with it
+    BlockStoreInterface& store = Hal::blockStore();
+    size_t offset = slotOffset(record.sequence);
+    if (record.sequence % sectorRecords == 0
+        && !store.erase(offset, sectorRecords * sizeof(JournalRecord))) {
+        Serial.println("Journal erase failed");
+        return;
+    }
+    if (!store.write(offset, &record, sizeof(record))) {
+        Serial.println("Journal write failed");
+        return;
+    }
+    nextSequence++;
+
+    // Full ring: the erase took the oldest pending readings
+    if (oldestSequence < oldestKept()) {
+        droppedCount += oldestKept() - oldestSequence;
+        oldestSequence = oldestKept();
+    }
+}
+
+size_t Journal::peek(Reading* readings, size_t max) {
+    size_t count = 0;
+    while (count < max && count < pending()) {
+        JournalRecord record;
+        if (!readSlot(oldestSequence + count, record)) {
+            if (count > 0) break; // Deliver what came before, the bad slot is dropped on the next call
+            // Torn or stale slot (e.g. power lost during the write), nothing to deliver
+            oldestSequence++;
+            droppedCount++;
+            continue;
+        }
+        readings[count].timestamp = 0;
+        readings[count].epoch = record.epoch;
+        readings[count].value = record.value;
+        readings[count].min = record.min;
+        readings[count].max = record.max;
+        readings[count].mean = record.mean;
+        readings[count].stddev = record.stddev;
+        readings[count].count = record.count;
+        readings[count].channelCount = 0;   // Records keep the device's own value only
+        readings[count].alarm = ALARM_FLAG_NONE;    // Records do not keep the alarm flag
+        count++;
+    }
+    return count;
+}
+
+void Journal::pop(size_t count) {
+    if (count > pending()) count = pending();
+    if (count == 0) return;
+    oldestSequence += count;
+    popsSinceAck += count;
+    if (popsSinceAck >= JOURNAL_ACK_EVERY || pending() == 0) {
+        saveAck();
+    }
+}
+
+bool Journal::readSlot(uint32_t sequence, JournalRecord& record) {
+    return Hal::blockStore().read(slotOffset(sequence), &record, sizeof(record))
+        && record.sequence == sequence && record.crc == recordCrc(record);
+}
+
+bool Journal::slotErased(uint32_t sequence) {
+    uint8_t bytes[sizeof(JournalRecord)];
+    if (!Hal::blockStore().read(slotOffset(sequence), bytes, sizeof(bytes))) return false;
+    for (uint8_t byte : bytes) {
+        if (byte != 0xFF) return false;
+    }
+    return true;
+}
+
+// The sector of the last record was erased when its first record went in; everything older that shared it
+// is gone, the other sectors still hold a whole lap
+uint32_t Journal::oldestKept() const {
+    uint32_t sectorStart = (nextSequence - 1) / sectorRecords * sectorRecords;
+    return sectorStart + sectorRecords > JOURNAL_CAPACITY ? sectorStart + sectorRecords - JOURNAL_CAPACITY : 1;
+}
+
+void Journal::saveAck() {
+    Hal::storage().putUInt(ackKey, oldestSequence);
+    popsSinceAck = 0;
+}
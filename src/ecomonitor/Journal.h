@@ -0,0 +1,71 @@
+/*
+ * File: Journal.h
+ * Description: Store-and-forward journal for readings that could not be uploaded. Readings are appended to a
+ *              fixed-size ring of records in flash and survive reboots until the API has accepted them.
+ *
+ *              Flash use is bounded by JOURNAL_CAPACITY records of 32 bytes in a raw data partition: 128 KB,
+ *              32 sectors of 4 KB holding 128 records each. Flash can only clear bits, so a sector is erased
+ *              just before the first record of a lap goes into it, and the records then fill it in sequence
+ *              order. Every sector is erased once per lap, i.e. once per 4096 records; at the 100,000 erase
+ *              cycles the flash is rated for, that is 409 million records, over 11,000 years at the default
+ *              15-minute interval and still over 700 years with every 1-minute reading going through the
+ *              journal. When the ring is full, erasing the next sector drops the oldest pending readings in it
+ *              (counted as dropped), so the journal always keeps the most recent history. The position of the
+ *              oldest pending record is kept in NVS and saved every JOURNAL_ACK_EVERY deliveries; after a power
+ *              loss up to that many readings can be uploaded twice, but none are lost.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_JOURNAL_H
+#define ECOMONITOR_JOURNAL_H
+
+#include <Arduino.h>
+
+#include "Sampler.h"
+
+#ifndef JOURNAL_CAPACITY
+#define JOURNAL_CAPACITY 4096 // 128 KB of flash, about 42 days of readings at the default 15-minute interval
+#endif
+#define JOURNAL_ACK_EVERY 16
+#define JOURNAL_DRAIN_INTERVAL 1000   // Pause between two backlog uploads while draining
+#define JOURNAL_RETRY_INTERVAL 60000  // Pause after a failed backlog upload
+
+struct JournalRecord {
+    uint32_t sequence; // Starts at 1; an erased slot (all 0xFF) fails its CRC
+    uint32_t epoch;
+    float value;
+    float min;
+    float max;
+    float mean;
+    float stddev;
+    uint16_t count;
+    uint16_t crc;      // Lower half of the CRC-32 of the fields above
+};
+
+class Journal {
+public:
+    bool begin();                        // Finds the newest and oldest pending record after a reboot
+    void append(const Reading& reading);
+    size_t peek(Reading* readings, size_t max); // Copies up to max of the oldest pending readings
+    void pop(size_t count = 1);               // The oldest count readings were delivered
+    uint32_t pending() const { return nextSequence - oldestSequence; }
+    uint32_t dropped() const { return droppedCount; }
+
+private:
+    bool readSlot(uint32_t sequence, JournalRecord& record);
+    bool slotErased(uint32_t sequence);
+    uint32_t oldestKept() const;
+    void saveAck();
+
+    bool ready = false;
+    uint32_t sectorRecords = 1;
+    uint32_t nextSequence = 1;
+    uint32_t oldestSequence = 1;
+    uint32_t popsSinceAck = 0;
+    uint32_t droppedCount = 0;
+};
+
+#endif
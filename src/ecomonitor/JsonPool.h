@@ -0,0 +1,93 @@
+/*
+ * File: JsonPool.h
+ * Description: ArduinoJson allocator backed by a fixed, statically allocated arena. Allocations are bumped off
+ *              the arena and the whole arena is reused as soon as the last block is freed, which happens when
+ *              the JsonDocument using it goes out of scope. A document that does not fit fails with NoMemory
+ *              instead of falling back to the heap.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_JSON_POOL_H
+#define ECOMONITOR_JSON_POOL_H
+
+#include <ArduinoJson.h>
+#include <stdint.h>
+#include <string.h>
+
+template <size_t N>
+class JsonPool : public ArduinoJson::Allocator {
+public:
+    void* allocate(size_t size) override {
+        size_t end = used + HEADER + align(size);
+        if (end > N) {
+            failures++;
+            return nullptr;
+        }
+        uint8_t* block = arena + used + HEADER;
+        setSize(block, size);
+        used = end;
+        if (used > peakUsed) peakUsed = used;
+        live++;
+        last = block;
+        return block;
+    }
+
+    void deallocate(void* ptr) override {
+        if (!ptr) return;
+        if (ptr == last) {
+            used = (uint8_t*)ptr - HEADER - arena;
+            last = nullptr;
+        }
+        if (--live == 0) {
+            used = 0;
+            last = nullptr;
+        }
+    }
+
+    void* reallocate(void* ptr, size_t size) override {
+        if (!ptr) return allocate(size);
+
+        // The newest block can grow and shrink in place
+        if (ptr == last) {
+            size_t end = (uint8_t*)ptr - arena + align(size);
+            if (end > N) {
+                failures++;
+                return nullptr;
+            }
+            setSize(ptr, size);
+            used = end;
+            if (used > peakUsed) peakUsed = used;
+            return ptr;
+        }
+
+        size_t oldSize = sizeOf(ptr);
+        if (size <= oldSize) return ptr;
+        void* moved = allocate(size);
+        if (!moved) return nullptr;
+        memcpy(moved, ptr, oldSize);
+        deallocate(ptr);
+        return moved;
+    }
+
+    size_t peak() const { return peakUsed; }          // Most of the arena ever in use, for sizing N
+    unsigned long failedAllocations() const { return failures; }
+
+private:
+    static const size_t HEADER = (sizeof(size_t) + 7) & ~(size_t)7;
+
+    static size_t align(size_t size) { return (size + 7) & ~(size_t)7; }
+    static size_t sizeOf(void* block) { size_t size; memcpy(&size, (uint8_t*)block - HEADER, sizeof(size)); return size; }
+    static void setSize(void* block, size_t size) { memcpy((uint8_t*)block - HEADER, &size, sizeof(size)); }
+
+    alignas(8) uint8_t arena[N];
+    size_t used = 0;
+    size_t peakUsed = 0;
+    size_t live = 0;
+    uint8_t* last = nullptr;
+    unsigned long failures = 0;
+};
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * File: LiveStream.cpp
+ * Description: Sample fan-out to LAN subscribers, see LiveStream.h.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <atomic>
+
+#include "LiveStream.h"
+#include "EcoMonitor.h"
+#include "hal/Hal.h"
+
+static WebServerInterface& server = Hal::webServer();
+
+// Client ids, 0 for a free slot; connects and disconnects arrive on the server task
+static std::atomic<uint32_t> clients[LIVE_MAX_CLIENTS];
+static std::atomic<unsigned long> refused(0);
+static LiveStreamStats counters = {0, 0, 0, 0, 0, 0, 0};
+
+// Server task side
+static void onClient(uint32_t client, bool connected) {
+    for (std::atomic<uint32_t>& slot : clients) {
+        uint32_t expected = connected ? 0 : client;
+        if (slot.compare_exchange_strong(expected, connected ? client : 0)) return;
+    }
+    if (connected) {
+        refused++;
+        server.streamClose(client);
+    }
+}
+
+namespace LiveStream {
+    void begin() {
+        server.openStream(LIVE_STREAM_URI, onClient);
+    }
+
+    void publish(const Sample& sample) {
+        unsigned long start = micros();
+        char message[96];
+        int length = snprintf(message, sizeof(message), "{\"value\":%.3f,\"unit\":\"%s\",\"timestamp\":%lu,\"ms\":%lu}",
+                              sample.value, getMeasurementUnit(), (unsigned long)sample.epoch, sample.timestamp);
+        if (length <= 0 || length >= (int)sizeof(message)) return;
+
+        for (std::atomic<uint32_t>& slot : clients) {
+            uint32_t client = slot.load();
+            if (client == 0) continue;
+            if (server.streamQueued(client) >= LIVE_CLIENT_QUEUE) {
+                Serial.printf("Live stream: client %lu fell behind, disconnected\n", (unsigned long)client);
+                counters.dropped++;
+                server.streamClose(client);
+                uint32_t expected = client;
+                slot.compare_exchange_strong(expected, 0);  // Unless the disconnect event was faster
+                continue;
+            }
+            server.streamSend(client, message, length);
+            counters.messages++;
+            counters.bytes += length;
+        }
+
+        unsigned long elapsed = micros() - start;
+        counters.samples++;
+        counters.micros += elapsed;
+        if (elapsed > counters.maxMicros) counters.maxMicros = elapsed;
+    }
+
+    size_t subscribers() {
+        size_t count = 0;
+        for (std::atomic<uint32_t>& slot : clients) {
+            if (slot.load() != 0) count++;
+        }
+        return count;
+    }
+
+    LiveStreamStats stats() {
+        LiveStreamStats copy = counters;
+        copy.refused = refused.load();
+        return copy;
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ * File: LiveStream.h
+ * Description: Pushes every sample to dashboards on the LAN over a WebSocket on the portal's server
+ *              (LIVE_STREAM_URI), as one small JSON text message:
+ *                  {"value":12.345,"unit":" ppm","timestamp":1768150000,"ms":123456}
+ *              The message is formatted once per sample and queued to every subscriber. Each subscriber may
+ *              have at most LIVE_CLIENT_QUEUE messages waiting; one that falls further behind is disconnected
+ *              instead of growing its queue, so a stalled dashboard cannot take the heap with it. Subscribers
+ *              past LIVE_MAX_CLIENTS are refused.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_LIVE_STREAM_H
+#define ECOMONITOR_LIVE_STREAM_H
+
+#include <Arduino.h>
+
+#include "Sampler.h"
+
+#define LIVE_STREAM_URI "/api/live"
+#ifndef LIVE_MAX_CLIENTS
+#define LIVE_MAX_CLIENTS 4      // Every WebSocket client costs an lwIP connection and its send buffers
+#endif
+#ifndef LIVE_CLIENT_QUEUE
+#define LIVE_CLIENT_QUEUE 6     // Messages a subscriber may have waiting, 30 s of samples at the 5 s tick
+#endif
+
+struct LiveStreamStats {
+    unsigned long samples;      // Published
+    unsigned long messages;     // Queued to subscribers
+    unsigned long bytes;
+    unsigned long dropped;      // Subscribers disconnected for falling behind
+    unsigned long refused;      // Subscribers over LIVE_MAX_CLIENTS
+    unsigned long micros;       // Spent in publish()
+    unsigned long maxMicros;
+};
+
+namespace LiveStream {
+    void begin();               // Registers the stream on the web server, before it starts
+    void publish(const Sample& sample);  // Loop side
+    size_t subscribers();
+    LiveStreamStats stats();
+}
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ * File: MqttChannel.cpp
+ * Description: MQTT command channel, see MqttChannel.h. Everything but begin() and nextCommand() runs on the MQTT
+ *              task; publishTelemetry() is called by the uploader task.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <ctype.h>
+
+#include "MqttChannel.h"
+#include "Payload.h"
+#include "SpscQueue.h"
+#include "hal/Hal.h"
+
+struct TelemetryMessage {
+    uint16_t length;
+    uint8_t payload[MQTT_TELEMETRY_SIZE];
+};
+
+static MqttInterface& mqtt = Hal::mqtt();
+static NetworkInterface& network = Hal::network();
+
+static SpscQueue<ApiCommand, COMMAND_QUEUE_SIZE> commandQueue;             // MQTT task -> main loop
+static SpscQueue<TelemetryMessage, MQTT_TELEMETRY_QUEUE> telemetryQueue;   // Uploader task -> MQTT task
+static TelemetryMessage outgoing;       // Filled by the uploader task
+static TelemetryMessage telemetry;      // Taken off the queue by the MQTT task
+
+static bool channelEnabled = false;
+static bool taskRunning = false;
+static char clientId[40];
+static char brokerHost[64];
+static uint16_t brokerPort = MQTT_PORT;
+static char commandTopic[80];
+static char telemetryTopic[80];
+static char statusTopic[80];
+
+static std::atomic<bool> isConnected(false);
+static std::atomic<unsigned long> receivedCount(0);
+static unsigned long lastAttempt = 0;
+static unsigned long retryDelay = 0;    // 0: the next attempt goes out at once
+static bool messageTaken = false;
+static bool messageRefused = false;
+static unsigned long refusals = 0;      // Deliveries in a row of messages that were not commands
+
+// Runs inside mqtt.loop(); the payload is JSON or MessagePack, like the body of an upload response. false leaves
+// the message unacknowledged, the broker sends it again after the reconnect.
+static bool handleMessage(const char* topic, const uint8_t* payload, size_t length) {
+    messageTaken = true;
+    if (strcmp(topic, commandTopic) != 0) return true;
+
+    // A MessagePack command is a map (0x80..0x8f), JSON may come after whitespace
+    size_t start = 0;
+    while (start < length && isspace(payload[start])) start++;
+    PayloadEncoding format = start < length && payload[start] == '{' ? PAYLOAD_JSON : PAYLOAD_MSGPACK;
+    ApiCommand command;
+    if (!Payload::decodeCommand((const char*)payload, length, Payload::contentType(format), command)) {
+        if (++refusals < MQTT_REDELIVERY_MAX) {
+            Serial.println("MQTT message is not a command, left with the broker");
+            messageRefused = true;
+            return false;
+        }
+        Serial.printf("MQTT message is not a command after %u deliveries, dropped\n", (unsigned)MQTT_REDELIVERY_MAX);
+        refusals = 0;
+        return true;
+    }
+    refusals = 0;
+
+    // step() only takes a message while the queue has room; if it is full anyway, the broker keeps the command
+    if (!commandQueue.push(command)) {
+        messageRefused = true;
+        return false;
+    }
+    Serial.print("Found command on MQTT: ");
+    Serial.println(command.command);
+    receivedCount++;
+    return true;
+}
+
+static bool connect() {
+    Serial.printf("Connecting to MQTT broker %s:%u\n", brokerHost, brokerPort);
+    if (!mqtt.connect(brokerHost, brokerPort, clientId, statusTopic, "offline") || !mqtt.subscribe(commandTopic)) {
+        mqtt.disconnect();
+        return false;
+    }
+    mqtt.publish(statusTopic, (const uint8_t*)"online", 6, true);
+    return true;
+}
+
+namespace MqttChannel {
+    void begin(const char* deviceId, const char* broker, uint16_t port) {
+        channelEnabled = broker[0] != '\0';
+        if (!channelEnabled) return;
+
+        strlcpy(brokerHost, broker, sizeof(brokerHost));
+        brokerPort = port;
+        snprintf(clientId, sizeof(clientId), "%s-%s", MQTT_TOPIC_PREFIX, deviceId);
+        snprintf(commandTopic, sizeof(commandTopic), "%s/%s/commands", MQTT_TOPIC_PREFIX, deviceId);
+        snprintf(telemetryTopic, sizeof(telemetryTopic), "%s/%s/telemetry", MQTT_TOPIC_PREFIX, deviceId);
+        snprintf(statusTopic, sizeof(statusTopic), "%s/%s/status", MQTT_TOPIC_PREFIX, deviceId);
+        mqtt.onMessage(handleMessage);
+        retryDelay = 0;
+
+        if (taskRunning) return;
+        taskRunning = Hal::system().startTask("mqtt", step, MQTT_TASK_PERIOD, MQTT_TASK_STACK_SIZE, UPLOADER_CORE);
+        if (!taskRunning) {
+            Serial.println("MQTT task could not be started, polling the broker from the main loop");
+        }
+    }
+
+    bool enabled() { return channelEnabled; }
+    bool connected() { return isConnected; }
+    bool isTaskRunning() { return taskRunning; }
+    unsigned long received() { return receivedCount; }
+    bool nextCommand(ApiCommand& command) { return commandQueue.pop(command); }
+
+    void step() {
+        if (!channelEnabled) return;
+        if (!mqtt.connected()) {
+            isConnected = false;
+            if (!network.isConnected() || millis() - lastAttempt < retryDelay) return;
+            lastAttempt = millis();
+            if (!connect()) {
+                retryDelay = retryDelay == 0 ? MQTT_RETRY_INTERVAL : std::min(retryDelay * 2, (unsigned long)MQTT_RETRY_MAX);
+                Serial.printf("MQTT broker not reached, next attempt in %lu s\n", retryDelay / 1000);
+                return;
+            }
+            retryDelay = 0;
+            isConnected = true;
+        }
+
+        while (telemetryQueue.pop(telemetry)) {
+            mqtt.publish(telemetryTopic, telemetry.payload, telemetry.length, false);
+        }
+
+        // loop() takes at most one message; a full command queue leaves the rest with the broker, in order.
+        // loop() also sends the keep-alive, so a queue the main loop leaves full for more than 1.5 times
+        // MQTT_KEEPALIVE_SECONDS makes the broker drop the connection; the commands stay in the session.
+        while (commandQueue.size() < commandQueue.capacity()) {
+            messageTaken = false;
+            messageRefused = false;
+            if (!mqtt.loop() || !messageTaken) break;
+            if (messageRefused) {
+                // The connection was dropped without the acknowledgement; the redelivery waits for the next attempt
+                lastAttempt = millis();
+                retryDelay = MQTT_RETRY_INTERVAL;
+                break;
+            }
+        }
+    }
+
+    void publishTelemetry(const uint8_t* payload, size_t length) {
+        if (!channelEnabled || !isConnected || length > MQTT_TELEMETRY_SIZE) return;
+        outgoing.length = length;
+        memcpy(outgoing.payload, payload, length);
+        telemetryQueue.push(outgoing);  // Best effort, the upload itself is the record
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ * File: MqttChannel.h
+ * Description: Push channel for commands. With a broker configured, a task of its own keeps an MQTT connection
+ *              open and subscribes to ecomonitor/<device_id>/commands, so a command published there reaches the
+ *              main loop within MQTT_TASK_PERIOD instead of waiting for the next upload response, even while the
+ *              uploader task waits on a slow request. Several commands in a row are executed in the order they
+ *              were published: messages are taken from the broker only while the command queue has room, and the
+ *              persistent session keeps those sent while the device was offline. A message that is not a command
+ *              is not acknowledged, so the broker delivers it again, up to MQTT_REDELIVERY_MAX times.
+ *              Every upload is also published to ecomonitor/<device_id>/telemetry, and the retained
+ *              ecomonitor/<device_id>/status says "online", or "offline" as the will of a lost connection.
+ *              The HTTP API stays the record of the readings and commands in its responses are still executed,
+ *              so without a broker, while it is unreachable, or in deep-sleep mode, the device works as before.
+ *              The broker is set with the change_mqtt_broker command ("host[:port]", empty to turn it off).
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_MQTT_CHANNEL_H
+#define ECOMONITOR_MQTT_CHANNEL_H
+
+#include <Arduino.h>
+
+#include "Uploader.h"
+
+#ifndef MQTT_BROKER
+#define MQTT_BROKER ""              // Host of the broker, empty turns the channel off
+#endif
+#ifndef MQTT_PORT
+#define MQTT_PORT 1883
+#endif
+#define MQTT_TOPIC_PREFIX "ecomonitor"
+#define MQTT_KEEPALIVE_SECONDS 30  // Not sent while the command queue is full, see MqttChannel::step()
+#define MQTT_SOCKET_TIMEOUT_SECONDS 5
+#define MQTT_PACKET_SIZE 2048
+#define MQTT_TELEMETRY_SIZE 1024    // Larger uploads are not published on the telemetry topic
+#define MQTT_TELEMETRY_QUEUE 2      // Uploads waiting for the MQTT task; more are not published
+#define MQTT_RETRY_INTERVAL 1000    // ms before the first reconnect, doubled after each failure
+#define MQTT_RETRY_MAX 60000
+#define MQTT_REDELIVERY_MAX 3       // Deliveries of a message that is not a command before it is acknowledged anyway
+#define MQTT_TASK_PERIOD 50         // ms between two passes of the MQTT task
+#define MQTT_TASK_STACK_SIZE 4096
+
+namespace MqttChannel {
+    // Main loop side; an empty broker leaves the channel off, otherwise begin() starts the MQTT task
+    void begin(const char* deviceId, const char* broker, uint16_t port);
+    bool enabled();
+    bool connected();
+    bool isTaskRunning();
+    unsigned long received();       // Commands taken from the broker since begin()
+    bool nextCommand(ApiCommand& command);
+
+    // MQTT task side, or the main loop when the task could not be started
+    void step();                    // Keeps the connection and takes the commands that fit the command queue
+
+    // Uploader task side; the MQTT task publishes it
+    void publishTelemetry(const uint8_t* payload, size_t length);
+}
+
+#endif
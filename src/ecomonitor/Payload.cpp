@@ -0,0 +1,104 @@
+/*
+ * File: Payload.cpp
+ * Description: Request encoding and response decoding, see Payload.h. Both documents live on a static arena,
+ *              so encoding and decoding never touch the heap.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <ArduinoJson.h>
+
+#include "Payload.h"
+#include "JsonPool.h"
+#include "Profiler.h"
+
+static JsonPool<UPLOAD_JSON_POOL_SIZE> jsonPool;
+static JsonPool<128> filterPool;
+
+// Only these fields of a response are kept
+static JsonDocument& responseFilter() {
+    static JsonDocument filter(&filterPool);
+    if (filter.isNull()) {
+        filter["command"] = true;
+        filter["payload"] = true;
+    }
+    return filter;
+}
+
+static void writeReading(JsonObject out, const Reading& reading) {
+    out["final_value"] = reading.value;
+    if (reading.epoch != 0) {
+        out["timestamp"] = reading.epoch;
+    }
+    if (reading.count > 1) {
+        out["count"] = reading.count;
+        out["min"] = reading.min;
+        out["max"] = reading.max;
+        out["mean"] = reading.mean;
+        out["stddev"] = reading.stddev;
+    }
+    if (reading.channelCount > 0) {
+        JsonObject channels = out["channels"].to<JsonObject>();
+        for (uint8_t i = 0; i < reading.channelCount; i++) {
+            channels[channelName(reading.channels[i].id)] = reading.channels[i].value;
+        }
+    }
+    if (reading.alarm != ALARM_FLAG_NONE) {
+        out["alarm"] = reading.alarm == ALARM_FLAG_RAISED;
+    }
+}
+
+namespace Payload {
+    const char* contentType(PayloadEncoding encoding) {
+        return encoding == PAYLOAD_MSGPACK ? CONTENT_TYPE_MSGPACK : CONTENT_TYPE_JSON;
+    }
+
+    PayloadEncoding encodingOf(const char* contentType) {
+        // Also matches application/x-msgpack and a trailing "; charset=..."
+        return contentType && strstr(contentType, "msgpack") ? PAYLOAD_MSGPACK : PAYLOAD_JSON;
+    }
+
+    bool encodingFromName(const char* name, PayloadEncoding& encoding) {
+        if (strcmp(name, "json") == 0) encoding = PAYLOAD_JSON;
+        else if (strcmp(name, "msgpack") == 0) encoding = PAYLOAD_MSGPACK;
+        else return false;
+        return true;
+    }
+
+    size_t encodeReadings(const char* deviceId, const Reading* readings, size_t count, PayloadEncoding encoding,
+                          uint8_t* out, size_t size) {
+        PROFILE_SCOPE(PROFILE_JSON_ENCODE);
+        JsonDocument doc(&jsonPool);
+        JsonObject root = doc.to<JsonObject>();
+        root["device_id"] = deviceId;
+        if (count == 1) {
+            writeReading(root, readings[0]);
+        } else {
+            JsonArray list = root["readings"].to<JsonArray>();
+            for (size_t i = 0; i < count; i++) {
+                writeReading(list.add<JsonObject>(), readings[i]);
+            }
+        }
+        if (doc.overflowed()) return 0;
+
+        // Both serializers cut off silently, so a buffer filled up to its last byte means it did not fit
+        size_t length = encoding == PAYLOAD_MSGPACK ? serializeMsgPack(doc, out, size)
+                                                    : serializeJson(doc, (char*)out, size);
+        return length + 1 < size ? length : 0;
+    }
+
+    bool decodeCommand(const char* body, size_t length, const char* contentType, ApiCommand& command) {
+        if (length == 0) return false;
+
+        JsonDocument doc(&jsonPool);
+        DeserializationOption::Filter filter(responseFilter());
+        DeserializationError error = encodingOf(contentType) == PAYLOAD_MSGPACK
+            ? deserializeMsgPack(doc, body, length, filter)
+            : deserializeJson(doc, body, length, filter);
+        if (error || !doc["command"].is<const char*>()) return false;
+
+        strlcpy(command.command, doc["command"].as<const char*>(), sizeof(command.command));
+        strlcpy(command.payload, doc["payload"] | "", sizeof(command.payload));
+        return true;
+    }
+}
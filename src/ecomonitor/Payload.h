@@ -0,0 +1,39 @@
+/*
+ * File: Payload.h
+ * Description: Encoding of the upload requests and decoding of the API responses. Readings can be sent as JSON
+ *              or, opt-in, as MessagePack with the same structure; the Content-Type header tells the server which
+ *              one it got, and the Content-Type of the response tells the device how to read the reply.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_PAYLOAD_H
+#define ECOMONITOR_PAYLOAD_H
+
+#include <Arduino.h>
+
+#include "Sampler.h"
+#include "Uploader.h"
+
+#define CONTENT_TYPE_JSON "application/json"
+#define CONTENT_TYPE_MSGPACK "application/msgpack"
+
+namespace Payload {
+    const char* contentType(PayloadEncoding encoding);
+    PayloadEncoding encodingOf(const char* contentType);   // JSON for anything that is not MessagePack
+    bool encodingFromName(const char* name, PayloadEncoding& encoding);  // "json" or "msgpack"
+
+    // {"device_id", "final_value"[, "timestamp"]} for one reading, {"device_id", "readings": [...]} for several.
+    // A reading that summarises more than one sample also carries "count", "min", "max", "mean" and "stddev",
+    // one from a multi-channel sensor the further channels as "channels": {"temperature": 21.4}.
+    // Returns the encoded length, or 0 if the readings do not fit into size bytes.
+    size_t encodeReadings(const char* deviceId, const Reading* readings, size_t count, PayloadEncoding encoding,
+                          uint8_t* out, size_t size);
+
+    // Reads {"command", "payload"} from a response body; false if it carries no command
+    bool decodeCommand(const char* body, size_t length, const char* contentType, ApiCommand& command);
+}
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * File: Portal.cpp
+ * Description: Configuration portal and local HTTP API, see Portal.h.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <atomic>
+
+#include "Portal.h"
+#include "EcoMonitor.h"
+#include "LiveStream.h"
+#include "PortalPages.h"
+#include "Profiler.h"
+#include "hal/Hal.h"
+
+static WebServerInterface& server = Hal::webServer();
+
+static bool started = false;
+static std::atomic<bool> configurable(false);
+static char deviceId[24] = "";
+static char apiUrl[96] = "";
+
+// Sequence counter: odd while the loop writes, the server task copies again if it changed under it
+static std::atomic<uint32_t> sequence(0);
+static PortalSnapshot published = {false, 0, 0, 0, "off", "", 0};
+
+// Filled by the server task, taken by the loop
+static std::atomic<bool> credentialsReady(false);
+static char pendingSsid[33];
+static char pendingPassword[65];
+static bool credentialsTaken = false;   // Loop side; the device restarts after that, later submits are ignored
+
+static PortalSnapshot readSnapshot() {
+    PortalSnapshot copy;
+    uint32_t before, after;
+    do {
+        before = sequence.load(std::memory_order_acquire);
+        copy = published;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    return copy;
+}
+
+static void sendInfo(WebRequest& request) {
+    char body[256];
+    snprintf(body, sizeof(body), "{\"device_name\":\"%s\",\"device_id\":\"%s\",\"unit\":\"%s\",\"api_url\":\"%s\"}",
+             getDeviceName(), deviceId, getMeasurementUnit(), apiUrl);
+    request.send(200, "application/json", body);
+}
+
+static void sendReading(WebRequest& request) {
+    PortalSnapshot snapshot = readSnapshot();
+    char body[160];
+    if (snapshot.hasReading) {
+        snprintf(body, sizeof(body), "{\"value\":%.3f,\"unit\":\"%s\",\"timestamp\":%lu,\"age_ms\":%lu}",
+                 snapshot.value, getMeasurementUnit(), (unsigned long)snapshot.epoch, millis() - snapshot.sampledAt);
+    } else {
+        snprintf(body, sizeof(body), "{\"value\":null,\"unit\":\"%s\"}", getMeasurementUnit());
+    }
+    request.send(200, "application/json", body);
+}
+
+static void sendStatus(WebRequest& request) {
+    PortalSnapshot snapshot = readSnapshot();
+    SystemInterface& system = Hal::system();
+    char body[256];
+    snprintf(body, sizeof(body),
+             "{\"device_id\":\"%s\",\"uptime_s\":%lu,\"wifi\":\"%s\",\"api\":\"%s\",\"journal_pending\":%u,"
+             "\"free_heap\":%u,\"min_free_heap\":%u}",
+             deviceId, millis() / 1000, snapshot.wifi, snapshot.api, (unsigned)snapshot.journalPending,
+             (unsigned)system.freeHeap(), (unsigned)system.minFreeHeap());
+    request.send(200, "application/json", body);
+}
+
+static void sendMetrics(WebRequest& request) {
+    static char body[PROFILE_TEXT_SIZE];  // Server task only
+    if (Profiler::format(body, sizeof(body)) == 0) {
+        request.send(500, "text/plain", "Error: Metrics do not fit PROFILE_TEXT_SIZE");
+        return;
+    }
+    request.send(200, "text/plain; version=0.0.4", body);
+}
+
+static void receiveCredentials(WebRequest& request) {
+    if (!configurable.load()) {
+        request.send(403, "text/plain", "Error: Configuration only in AP mode");
+        return;
+    }
+    if (!request.hasArg("ssid") || request.arg("ssid").length() == 0) {
+        request.send(400, "text/plain", "Error: Missing WiFi Name");
+        return;
+    }
+    // A second submit before the loop took the first one only gets the page again
+    if (!credentialsReady.load(std::memory_order_acquire)) {
+        strlcpy(pendingSsid, request.arg("ssid").c_str(), sizeof(pendingSsid));
+        strlcpy(pendingPassword, request.arg("password").c_str(), sizeof(pendingPassword));
+        credentialsReady.store(true, std::memory_order_release);
+    }
+    request.sendGzip(200, "text/html", portalSavedPage, sizeof(portalSavedPage));
+}
+
+namespace Portal {
+    void begin(const char* id, const char* url, bool allowConfigure) {
+        configurable = allowConfigure;
+        if (started) return;
+        started = true;
+
+        strlcpy(deviceId, id, sizeof(deviceId));
+        strlcpy(apiUrl, url, sizeof(apiUrl));
+        server.onGet("/", [](WebRequest& request) {
+            request.sendGzip(200, "text/html", portalIndexPage, sizeof(portalIndexPage));
+        });
+        server.onGet("/api/info", sendInfo);
+        server.onGet("/api/reading", sendReading);
+        server.onGet("/api/status", sendStatus);
+        server.onGet("/metrics", sendMetrics);
+        server.onPost("/configure", receiveCredentials);
+        LiveStream::begin();
+        server.begin();
+        Serial.println("HTTP server started");
+    }
+
+    void publish(const PortalSnapshot& snapshot) {
+        uint32_t current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        published = snapshot;
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+    bool takeCredentials(char* ssid, size_t ssidSize, char* password, size_t passwordSize) {
+        if (credentialsTaken || !credentialsReady.load(std::memory_order_acquire)) return false;
+        credentialsTaken = true;
+        strlcpy(ssid, pendingSsid, ssidSize);
+        strlcpy(password, pendingPassword, passwordSize);
+        return true;
+    }
+}
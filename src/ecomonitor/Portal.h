@@ -0,0 +1,49 @@
+/*
+ * File: Portal.h
+ * Description: Configuration portal and local read-only HTTP API on the async web server. The pages are
+ *              gzip-compressed at build time (the pages in portal/, see PortalPages.h) and served from flash as they
+ *              are; the page fills in the device ID, API URL and the current reading from the JSON endpoints:
+ *                  GET  /              setup page
+ *                  GET  /api/info      device name, ID, unit, API URL
+ *                  GET  /api/reading   last sample with its age
+ *                  GET  /api/status    Wi-Fi, API and journal state, uptime, heap
+ *                  GET  /metrics       latency histograms, heap and stack gauges as Prometheus text, see Profiler.h
+ *                  POST /configure     Wi-Fi credentials, AP mode only
+ *                  WS   /api/live      every sample as it is taken, see LiveStream.h
+ *              All handlers run on the server task. The loop publishes what they report with publish(), a
+ *              copy under a sequence counter, and picks up saved credentials with takeCredentials(); the
+ *              handlers never touch the configuration, the display or the sensor.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_PORTAL_H
+#define ECOMONITOR_PORTAL_H
+
+#include <Arduino.h>
+
+#ifndef PORTAL_RESTART_DELAY
+#define PORTAL_RESTART_DELAY 5000   // ms from saving the credentials to the restart, lets the response reach the browser
+#endif
+
+// What the endpoints report, published by the loop
+struct PortalSnapshot {
+    bool hasReading;
+    float value;
+    uint32_t epoch;              // Of the sample, 0 before the first NTP sync
+    unsigned long sampledAt;     // millis() of the sample
+    const char* wifi;            // String literals only, the server task reads them later
+    const char* api;
+    uint16_t journalPending;
+};
+
+namespace Portal {
+    // Loop side. begin() starts the server once, later calls only change whether /configure is accepted
+    void begin(const char* deviceId, const char* apiUrl, bool configurable);
+    void publish(const PortalSnapshot& snapshot);
+    bool takeCredentials(char* ssid, size_t ssidSize, char* password, size_t passwordSize); // Once, after a submit
+}
+
+#endif
@@ -0,0 +1,117 @@
+/*
+ * File: PortalPages.h
+ * Description: Gzip-compressed portal pages, generated from the pages in portal/ by portal/build_pages.py.
+ *              Do not edit by hand.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_PORTAL_PAGES_H
+#define ECOMONITOR_PORTAL_PAGES_H
+
+#include <Arduino.h>
+
+// index.html: 2362 bytes, 1002 compressed
+static const uint8_t portalIndexPage[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x85, 0x56, 0x6d, 0x8f, 0xda, 0x46,
+    0x10, 0xfe, 0xce, 0xaf, 0x98, 0x38, 0x6a, 0x05, 0x2a, 0x06, 0x43, 0xa0, 0x3a, 0x8c, 0x6d, 0x29,
+    0xbd, 0xbb, 0x4a, 0x27, 0x55, 0xe9, 0x29, 0x69, 0x55, 0x55, 0x55, 0x14, 0x2d, 0xf6, 0x1a, 0x6f,
+    0x63, 0xef, 0xba, 0xeb, 0x35, 0x1c, 0x8d, 0xf2, 0xdf, 0x3b, 0xfb, 0x62, 0x30, 0x1c, 0xbd, 0xc0,
+    0x07, 0xbc, 0xb3, 0x33, 0xcf, 0x3c, 0xf3, 0x8a, 0xa3, 0x57, 0x77, 0xbf, 0xde, 0xfe, 0xf6, 0xe7,
+    0xe3, 0x3d, 0x14, 0xaa, 0x2a, 0x93, 0x41, 0xd4, 0xfd, 0x50, 0x92, 0x25, 0x03, 0xc0, 0x4f, 0xa4,
+    0x98, 0x2a, 0x69, 0xf2, 0x07, 0xfb, 0x99, 0xc1, 0xad, 0xe0, 0x39, 0xdb, 0xb6, 0x92, 0x28, 0x26,
+    0x78, 0x34, 0xb5, 0x37, 0x56, 0xab, 0xa2, 0x8a, 0x00, 0x27, 0x15, 0x8d, 0xbd, 0x1d, 0xa3, 0xfb,
+    0x5a, 0x48, 0xe5, 0x41, 0x2a, 0xb8, 0xa2, 0x5c, 0xc5, 0xde, 0x9e, 0x65, 0xaa, 0x88, 0x33, 0xba,
+    0x63, 0x29, 0xf5, 0xcd, 0x61, 0x0c, 0x8c, 0x33, 0xc5, 0x48, 0xe9, 0x37, 0x29, 0x29, 0x69, 0x3c,
+    0xf3, 0x1c, 0x50, 0xa3, 0x0e, 0x1d, 0xe8, 0x46, 0x64, 0x07, 0xf8, 0x02, 0x39, 0xa2, 0xf8, 0x39,
+    0xa9, 0x58, 0x79, 0x08, 0xe1, 0xad, 0x44, 0x9b, 0x31, 0x34, 0x84, 0x37, 0x7e, 0x43, 0x25, 0xcb,
+    0xd7, 0x50, 0x11, 0xb9, 0x65, 0x3c, 0x84, 0x45, 0x50, 0x3f, 0xad, 0x61, 0x43, 0xd2, 0xcf, 0x5b,
+    0x29, 0x5a, 0x9e, 0xf9, 0xa9, 0x28, 0x85, 0x0c, 0xe1, 0x75, 0x1e, 0xe8, 0xef, 0x1a, 0xbe, 0x1a,
+    0xd4, 0x89, 0x66, 0x45, 0x18, 0xa7, 0x12, 0xb1, 0x2b, 0xf2, 0x64, 0xf9, 0x84, 0xb0, 0x0c, 0x8c,
+    0x7d, 0x87, 0x16, 0x00, 0x69, 0x95, 0xe8, 0xe3, 0x85, 0xb0, 0x2f, 0x98, 0xa2, 0x6b, 0xa8, 0x49,
+    0x96, 0x31, 0xbe, 0x0d, 0x61, 0x6e, 0x3d, 0x0a, 0x99, 0x51, 0xe9, 0x4b, 0x92, 0xb1, 0xb6, 0x09,
+    0x61, 0xe6, 0x84, 0x4f, 0x7e, 0x53, 0x90, 0x4c, 0xec, 0x35, 0x54, 0x60, 0xa4, 0x20, 0xb7, 0x1b,
+    0x32, 0x0c, 0xc6, 0xe6, 0x3b, 0x99, 0x8d, 0x3a, 0x46, 0xc5, 0x1c, 0x99, 0x74, 0x64, 0xe7, 0xe9,
+    0x1b, 0xba, 0x44, 0xb2, 0x8a, 0x3e, 0x29, 0x9f, 0x94, 0x6c, 0x8b, 0x5c, 0x52, 0x4c, 0x22, 0x95,
+    0x9d, 0x3a, 0xe3, 0x75, 0xab, 0xfe, 0x52, 0x87, 0x1a, 0x73, 0xad, 0xb5, 0xbc, 0x8f, 0xe3, 0x33,
+    0x59, 0x4d, 0x9a, 0x66, 0x8f, 0x9c, 0xbc, 0x8f, 0xf0, 0xc5, 0x18, 0xe8, 0x8f, 0x0b, 0x72, 0x16,
+    0x04, 0xdf, 0xf5, 0x02, 0x98, 0xcd, 0xfb, 0x21, 0xdf, 0x20, 0xc5, 0x60, 0x7d, 0x34, 0xb1, 0x71,
+    0xa1, 0x12, 0x8a, 0x1b, 0x51, 0xb2, 0x0c, 0x5e, 0xa7, 0x69, 0xfa, 0x2c, 0xde, 0x05, 0x42, 0xf4,
+    0x6c, 0x30, 0x6c, 0xf6, 0xaf, 0x01, 0x77, 0x7a, 0x28, 0xb2, 0xf7, 0xcf, 0xd9, 0x37, 0xed, 0xa6,
+    0x62, 0xea, 0xff, 0x79, 0x5e, 0xa9, 0xe5, 0x9b, 0xc5, 0xea, 0x26, 0xdb, 0x9c, 0x1c, 0x3a, 0xf9,
+    0x65, 0x65, 0x66, 0x8b, 0x53, 0x65, 0x42, 0xe0, 0x82, 0xd3, 0xcb, 0xb8, 0xce, 0xf8, 0x43, 0xda,
+    0xca, 0x46, 0xe3, 0xd4, 0x82, 0x99, 0x54, 0x1f, 0x95, 0x4d, 0xf3, 0x61, 0x44, 0x14, 0x31, 0x7f,
+    0x3c, 0x25, 0xcb, 0x57, 0xa2, 0x76, 0xa5, 0xfe, 0x46, 0x6c, 0x61, 0x21, 0x76, 0xa6, 0xd5, 0xae,
+    0x04, 0x33, 0x5f, 0xdd, 0x04, 0x9b, 0x55, 0x57, 0xd7, 0x92, 0x6c, 0x68, 0xd9, 0xf5, 0xfb, 0x9e,
+    0xb2, 0x6d, 0xa1, 0x74, 0x12, 0xcb, 0x6c, 0x0d, 0xa7, 0xe8, 0x17, 0xab, 0x25, 0x3d, 0x76, 0xb2,
+    0x1b, 0x28, 0xc6, 0x73, 0x71, 0xe6, 0x40, 0xf7, 0xfc, 0x4d, 0xbe, 0xca, 0x49, 0x3f, 0x23, 0xcb,
+    0x2b, 0xbd, 0xba, 0xec, 0x45, 0xb4, 0x11, 0x4a, 0x89, 0xaa, 0x53, 0xb4, 0x1e, 0xa2, 0xa9, 0x1b,
+    0xc7, 0x68, 0x6a, 0x37, 0x42, 0xa4, 0x67, 0xd2, 0x4d, 0x6a, 0xc6, 0x76, 0x90, 0x96, 0xd8, 0x6c,
+    0xb1, 0x77, 0x1c, 0xa9, 0x6e, 0x8a, 0x8b, 0x79, 0x12, 0x35, 0x35, 0xe1, 0xc0, 0xb2, 0xd8, 0xd3,
+    0x6b, 0xc1, 0x4b, 0xee, 0x0c, 0x59, 0x44, 0x44, 0x71, 0x02, 0x66, 0x9f, 0x7c, 0xa0, 0xaa, 0xad,
+    0x11, 0x7a, 0x9e, 0x0c, 0x9e, 0x41, 0xf6, 0x62, 0x73, 0xa0, 0x6e, 0x3d, 0x48, 0xc1, 0xb7, 0x0e,
+    0x0c, 0x1e, 0xee, 0x42, 0x4d, 0xd1, 0x88, 0xe0, 0xe4, 0x90, 0x65, 0x5e, 0xe2, 0x1c, 0x45, 0x1b,
+    0xf9, 0xdc, 0xfa, 0xed, 0xe3, 0x03, 0xfc, 0xfe, 0xfe, 0x97, 0xab, 0xb6, 0xa4, 0x66, 0x2f, 0x1b,
+    0xbf, 0xc7, 0x44, 0xe8, 0x8c, 0x5e, 0x33, 0x96, 0xf6, 0xce, 0x4b, 0xfc, 0x4b, 0x84, 0x68, 0x8a,
+    0xb1, 0x75, 0x61, 0xe6, 0x42, 0x56, 0x40, 0x52, 0xbd, 0x45, 0x63, 0x6f, 0x9a, 0xba, 0xad, 0x4a,
+    0x3d, 0xc0, 0x2d, 0x5a, 0x08, 0xc4, 0xa9, 0x45, 0xa3, 0xfa, 0x51, 0xdb, 0xd6, 0x40, 0x33, 0xec,
+    0xab, 0x46, 0x47, 0x67, 0xd2, 0xf7, 0x8e, 0x2a, 0x9c, 0xf3, 0xcf, 0xf0, 0x0e, 0xf3, 0x8b, 0x74,
+    0x8c, 0x52, 0xcf, 0xc8, 0x74, 0x23, 0xf4, 0xf6, 0x84, 0xa1, 0x68, 0xec, 0xdd, 0xa6, 0xb6, 0xcf,
+    0x92, 0xfe, 0xd3, 0x32, 0x49, 0x33, 0xa8, 0x4b, 0x92, 0xd2, 0x02, 0x1b, 0x8e, 0xa2, 0x9f, 0x7b,
+    0x3d, 0x07, 0x70, 0x10, 0xad, 0xb4, 0xb5, 0xb2, 0x45, 0x1c, 0x5c, 0xe5, 0x74, 0xdc, 0x38, 0x96,
+    0xd7, 0xa3, 0x3b, 0x7e, 0x83, 0xd3, 0xd1, 0xca, 0xf0, 0x3a, 0x9d, 0x2c, 0xb7, 0xd3, 0xf9, 0x45,
+    0x5a, 0x27, 0xd7, 0x83, 0xeb, 0x5e, 0xdc, 0x1c, 0xc2, 0x8e, 0x94, 0x2d, 0x1e, 0x3f, 0x90, 0x1d,
+    0x85, 0xef, 0xf5, 0x3f, 0x19, 0xa7, 0x69, 0x97, 0xe3, 0x68, 0xaa, 0x2b, 0x72, 0x56, 0x28, 0x5b,
+    0xf1, 0x54, 0xb2, 0x5a, 0xd9, 0x43, 0xde, 0x72, 0x53, 0x30, 0x68, 0x0a, 0xb1, 0x1f, 0xb2, 0x6c,
+    0x6c, 0x36, 0xf4, 0x08, 0xe7, 0x2e, 0x13, 0x69, 0x5b, 0xe1, 0x86, 0x9e, 0x6c, 0xa9, 0xba, 0x2f,
+    0xa9, 0x7e, 0xfc, 0xe9, 0xf0, 0x90, 0xa1, 0xce, 0x68, 0xa2, 0x75, 0x6e, 0xed, 0xbf, 0x20, 0xc4,
+    0xc6, 0xa2, 0x1b, 0xad, 0x9c, 0xaa, 0xb4, 0x18, 0x7a, 0x53, 0xec, 0xb7, 0xa9, 0x69, 0x72, 0x54,
+    0x2e, 0x28, 0x1f, 0x4a, 0x88, 0x13, 0x90, 0x93, 0xbf, 0x1b, 0xc1, 0x87, 0x23, 0x27, 0x33, 0x03,
+    0x8e, 0xe2, 0xd3, 0x9a, 0x34, 0x24, 0xec, 0x60, 0xe9, 0xe5, 0x9f, 0x0b, 0xb7, 0x0b, 0x3e, 0x69,
+    0xd1, 0x68, 0x7d, 0xa1, 0x87, 0x55, 0x3e, 0xd7, 0x42, 0x6a, 0x97, 0x3a, 0xba, 0xef, 0x9d, 0x12,
+    0x3e, 0x7e, 0x6a, 0x65, 0xe9, 0x54, 0xbe, 0xba, 0xdf, 0x63, 0x02, 0x24, 0xcd, 0x25, 0x6d, 0x8a,
+    0xe1, 0xa8, 0xc7, 0xa7, 0x1f, 0x4d, 0x37, 0x04, 0x2f, 0x04, 0xe4, 0x54, 0xce, 0x63, 0x32, 0x1b,
+    0x34, 0x87, 0xee, 0x72, 0x62, 0x2a, 0x06, 0xaf, 0xe2, 0x18, 0x78, 0x5b, 0x96, 0x23, 0xc7, 0xb3,
+    0x43, 0x1f, 0xc3, 0xb9, 0xde, 0x0f, 0xc7, 0x73, 0x8b, 0x2f, 0x16, 0xbd, 0xf0, 0x3a, 0xfe, 0x36,
+    0xed, 0x47, 0xf2, 0x56, 0xd8, 0x50, 0xf5, 0xa0, 0x3b, 0x0a, 0x31, 0x86, 0xee, 0x6a, 0xac, 0xdf,
+    0x04, 0x02, 0x77, 0x8f, 0x63, 0xec, 0x7a, 0x20, 0x9a, 0xda, 0xd5, 0x87, 0xeb, 0xca, 0xbc, 0x22,
+    0xfd, 0x07, 0x22, 0x83, 0x9f, 0xcd, 0x3a, 0x09, 0x00, 0x00,
+};
+
+// saved.html: 806 bytes, 474 compressed
+static const uint8_t portalSavedPage[] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x6d, 0x53, 0x4b, 0x6f, 0xdb, 0x30,
+    0x0c, 0xbe, 0xf7, 0x57, 0xb0, 0xde, 0x25, 0x05, 0xe2, 0x47, 0x8a, 0x76, 0x03, 0xfc, 0x08, 0x30,
+    0xb4, 0x3b, 0x6f, 0xc0, 0x7a, 0xd9, 0x91, 0x91, 0x68, 0x9b, 0x98, 0x2c, 0x05, 0x92, 0x1c, 0x27,
+    0x2b, 0xfa, 0xdf, 0x27, 0x3b, 0x76, 0x92, 0x01, 0xa3, 0x0e, 0x86, 0xf8, 0xf8, 0xf8, 0xe9, 0x23,
+    0x5d, 0xde, 0xbf, 0x7e, 0x7f, 0x79, 0xfb, 0xf5, 0xe3, 0x1b, 0xb4, 0xbe, 0x53, 0xdb, 0xbb, 0x72,
+    0xf9, 0x10, 0xca, 0xed, 0x1d, 0x04, 0x2b, 0x3d, 0x7b, 0x45, 0xdb, 0x17, 0xa3, 0x6b, 0x6e, 0x7a,
+    0x8b, 0x9e, 0x8d, 0x86, 0x9f, 0x78, 0x20, 0x59, 0xa6, 0xe7, 0xd0, 0x39, 0xad, 0x23, 0x8f, 0xa0,
+    0xb1, 0xa3, 0x2a, 0x3a, 0x30, 0x0d, 0x7b, 0x63, 0x7d, 0x04, 0xc2, 0x68, 0x4f, 0xda, 0x57, 0xd1,
+    0xc0, 0xd2, 0xb7, 0x95, 0xa4, 0x03, 0x0b, 0x8a, 0xa7, 0xcb, 0x1a, 0x58, 0xb3, 0x67, 0x54, 0xb1,
+    0x13, 0xa8, 0xa8, 0xda, 0x44, 0x33, 0x90, 0xf3, 0xa7, 0x05, 0x74, 0xb4, 0x9d, 0x91, 0x27, 0x78,
+    0x87, 0x3a, 0x20, 0xc5, 0x35, 0x76, 0xac, 0x4e, 0x39, 0x7c, 0xb5, 0xa1, 0x6e, 0x0d, 0x0e, 0xb5,
+    0x8b, 0x1d, 0x59, 0xae, 0x0b, 0xe8, 0xd0, 0x36, 0xac, 0x73, 0x78, 0xca, 0xf6, 0xc7, 0x02, 0x3c,
+    0x1d, 0x7d, 0x8c, 0x8a, 0x9b, 0xe0, 0x11, 0x81, 0x00, 0xd9, 0x02, 0x76, 0x28, 0x7e, 0x37, 0xd6,
+    0xf4, 0x5a, 0xc6, 0xc2, 0x28, 0x63, 0x73, 0xf8, 0x54, 0x67, 0xe3, 0x29, 0xe0, 0xe3, 0xd2, 0x2d,
+    0x71, 0xbd, 0x10, 0xe4, 0x5c, 0xe8, 0xb8, 0x24, 0x3d, 0x7e, 0x41, 0xfa, 0x1c, 0x92, 0x26, 0x06,
+    0x8e, 0xff, 0x50, 0x0e, 0x8f, 0x4f, 0x63, 0x93, 0xc9, 0x31, 0x10, 0x37, 0xad, 0xcf, 0x03, 0x4d,
+    0x25, 0xff, 0x01, 0x1a, 0x9f, 0x8e, 0xac, 0xc9, 0x06, 0xa8, 0x0e, 0x8f, 0xe7, 0x47, 0x8f, 0xfc,
+    0x26, 0x82, 0x0b, 0xdd, 0x0c, 0xb0, 0xf7, 0xe6, 0x96, 0x5c, 0x0e, 0x43, 0xcb, 0x9e, 0x0a, 0xd8,
+    0xa3, 0x94, 0xac, 0x9b, 0xd0, 0x6d, 0xaa, 0xd8, 0x19, 0x2b, 0xc9, 0xc6, 0x16, 0x25, 0xf7, 0x2e,
+    0x87, 0xcd, 0xec, 0x3c, 0xc6, 0xae, 0x45, 0x69, 0x86, 0x11, 0x2a, 0x9b, 0xbc, 0x60, 0x9b, 0x1d,
+    0xae, 0xb2, 0xf5, 0x74, 0x92, 0xcd, 0xc3, 0xc2, 0xaa, 0x4c, 0x67, 0x65, 0xcb, 0xf4, 0x3c, 0xdd,
+    0x72, 0x94, 0x76, 0x16, 0x5d, 0xf2, 0x01, 0x84, 0x42, 0xe7, 0xaa, 0xe8, 0x42, 0x3c, 0xba, 0x0e,
+    0xe1, 0x36, 0x3e, 0x2b, 0x14, 0xfd, 0x6f, 0x25, 0xee, 0xcb, 0x34, 0x64, 0xde, 0xd4, 0xed, 0xb7,
+    0xaf, 0xd3, 0xcc, 0x61, 0x60, 0xa5, 0xc0, 0x92, 0xf3, 0x68, 0x3d, 0xa0, 0x96, 0xe3, 0x6a, 0x68,
+    0x12, 0x3e, 0x6c, 0x01, 0x3c, 0x83, 0xa3, 0x70, 0x95, 0x2e, 0x49, 0x92, 0x32, 0xdd, 0xcf, 0x94,
+    0xae, 0x48, 0xa5, 0x13, 0x96, 0xf7, 0xfe, 0x0a, 0xeb, 0xc8, 0xbf, 0x71, 0x47, 0xa6, 0xf7, 0xab,
+    0xba, 0xd7, 0x62, 0xec, 0xbf, 0x7a, 0x80, 0xf7, 0x4b, 0x7c, 0xb4, 0x81, 0x75, 0x90, 0x25, 0x51,
+    0x46, 0x4c, 0xfc, 0x92, 0xd6, 0x52, 0x0d, 0x15, 0x44, 0x69, 0x54, 0x5c, 0xf2, 0x3e, 0xd6, 0xf0,
+    0x9c, 0x65, 0xd9, 0x43, 0xb1, 0x08, 0x34, 0xf7, 0x29, 0xd3, 0xb3, 0x34, 0x41, 0xa9, 0xe9, 0x77,
+    0xf8, 0x0b, 0xe5, 0x21, 0xbf, 0x97, 0x26, 0x03, 0x00, 0x00,
+};
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ * File: Profiler.cpp
+ * Description: Hot-path histograms and heap/stack gauges, see Profiler.h.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <algorithm>
+#include <stdarg.h>
+
+#include "Profiler.h"
+#include "hal/Hal.h"
+
+// Upper bounds of the buckets in us and as the le label in seconds; the last bucket is +Inf
+static const uint32_t bucketBounds[PROFILE_BUCKETS - 1] = {
+    50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000, 2500000
+};
+static const char* const bucketLabels[PROFILE_BUCKETS - 1] = {
+    "0.00005", "0.0001", "0.00025", "0.0005", "0.001", "0.0025", "0.005", "0.01", "0.025", "0.05", "0.1", "0.25", "1", "2.5"
+};
+
+static const char* const pointNames[PROFILE_POINTS] = {
+    "sensor_read", "display_flush", "json_encode", "http_post", "command", "loop", "alarm_upload"
+};
+
+// Arduino's loop task, the uploader (Uploader.cpp) and the web server (AsyncTCP)
+static const char* const taskNames[] = {"loopTask", "uploader", "mqtt", "async_tcp"};
+
+// Sequence counter per point: odd while its writer updates it
+struct ProfileSlot {
+    std::atomic<uint32_t> sequence;
+    Histogram data;
+};
+static ProfileSlot slots[PROFILE_POINTS];
+
+// One line at a time, into a buffer or straight to serial
+class MetricsText {
+public:
+    MetricsText(char* buffer, size_t size) : buffer(buffer), size(size) {}
+
+    void add(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char line[128];
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(line, sizeof(line), format, args);
+        va_end(args);
+        if (written <= 0) return;
+        size_t n = std::min((size_t)written, sizeof(line) - 1);
+        if (buffer == nullptr) {
+            Serial.print(line);
+        } else if (length + n < size) {
+            memcpy(buffer + length, line, n + 1);
+            length += n;
+        } else {
+            overflow = true;
+        }
+    }
+
+    size_t length = 0;
+    bool overflow = false;
+
+private:
+    char* buffer;
+    size_t size;
+};
+
+static void writeMetrics(MetricsText& out) {
+    for (uint8_t point = 0; point < PROFILE_POINTS; point++) {
+        const char* name = pointNames[point];
+        Histogram histogram = Profiler::histogram((ProfilePoint)point);
+        out.add("# TYPE ecomonitor_%s_seconds histogram\n", name);
+        unsigned long cumulative = 0;
+        for (size_t bucket = 0; bucket < PROFILE_BUCKETS - 1; bucket++) {
+            cumulative += histogram.buckets[bucket];
+            out.add("ecomonitor_%s_seconds_bucket{le=\"%s\"} %lu\n", name, bucketLabels[bucket], cumulative);
+        }
+        out.add("ecomonitor_%s_seconds_bucket{le=\"+Inf\"} %lu\n", name, (unsigned long)histogram.count);
+        out.add("ecomonitor_%s_seconds_sum %.6f\n", name, histogram.sumMicros / 1e6);
+        out.add("ecomonitor_%s_seconds_count %lu\n", name, (unsigned long)histogram.count);
+        out.add("# TYPE ecomonitor_%s_max_seconds gauge\n", name);
+        out.add("ecomonitor_%s_max_seconds %.6f\n", name, histogram.maxMicros / 1e6);
+    }
+
+    SystemInterface& system = Hal::system();
+    out.add("# TYPE ecomonitor_heap_free_bytes gauge\necomonitor_heap_free_bytes %u\n", (unsigned)system.freeHeap());
+    out.add("# TYPE ecomonitor_heap_min_free_bytes gauge\necomonitor_heap_min_free_bytes %u\n",
+            (unsigned)system.minFreeHeap());
+    out.add("# TYPE ecomonitor_heap_largest_block_bytes gauge\necomonitor_heap_largest_block_bytes %u\n",
+            (unsigned)system.largestFreeBlock());
+    out.add("# TYPE ecomonitor_stack_min_free_bytes gauge\n");
+    for (const char* task : taskNames) {
+        uint32_t free = system.stackHighWater(task);
+        if (free > 0) out.add("ecomonitor_stack_min_free_bytes{task=\"%s\"} %u\n", task, (unsigned)free);
+    }
+    out.add("# TYPE ecomonitor_uptime_seconds gauge\necomonitor_uptime_seconds %lu\n", millis() / 1000);
+}
+
+namespace Profiler {
+    void record(ProfilePoint point, unsigned long elapsedMicros) {
+#if PROFILING
+        ProfileSlot& slot = slots[point];
+        uint32_t current = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(current + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        size_t bucket = 0;
+        while (bucket < PROFILE_BUCKETS - 1 && elapsedMicros > bucketBounds[bucket]) bucket++;
+        Histogram& histogram = slot.data;
+        histogram.buckets[bucket]++;
+        histogram.count++;
+        histogram.sumMicros += elapsedMicros;
+        if (elapsedMicros > histogram.maxMicros) histogram.maxMicros = elapsedMicros;
+
+        slot.sequence.store(current + 2, std::memory_order_release);
+#else
+        (void)point; (void)elapsedMicros;
+#endif
+    }
+
+    Histogram histogram(ProfilePoint point) {
+        ProfileSlot& slot = slots[point];
+        Histogram copy;
+        uint32_t before, after;
+        do {
+            before = slot.sequence.load(std::memory_order_acquire);
+            copy = slot.data;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = slot.sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+        return copy;
+    }
+
+    const char* pointName(ProfilePoint point) {
+        return point < PROFILE_POINTS ? pointNames[point] : "unknown";
+    }
+
+    size_t format(char* buffer, size_t size) {
+        MetricsText out(buffer, size);
+        writeMetrics(out);
+        return out.overflow ? 0 : out.length;
+    }
+
+    void dump() {
+        MetricsText out(nullptr, 0);
+        writeMetrics(out);
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * File: Profiler.h
+ * Description: Always-on latency histograms of the hot paths plus heap and stack gauges. A PROFILE_SCOPE(point)
+ *              at the top of a block times it with two micros() calls and counts the duration into one of
+ *              PROFILE_BUCKETS fixed buckets; nothing is allocated and the cost does not depend on how long the
+ *              device has been running, so the profiler stays on in release builds (PROFILING 0 compiles it out).
+ *              Every point has a single writer task; the writer bumps a sequence counter around its update and
+ *              readers on other tasks copy the histogram until they get a consistent one, like the portal snapshot.
+ *              format() and dump() write everything in the Prometheus text format; the portal serves it at
+ *              /metrics and the dump_metrics command prints it over serial.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_PROFILER_H
+#define ECOMONITOR_PROFILER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+#ifndef PROFILING
+#define PROFILING 1
+#endif
+#define PROFILE_BUCKETS 15          // 14 upper bounds from 50 us to 2.5 s plus +Inf
+#define PROFILE_TEXT_SIZE 8192      // Whole text of format(), about 7.5 KB with full counters
+
+enum ProfilePoint : uint8_t {
+    PROFILE_SENSOR_READ,            // readChannels(), one bus transaction
+    PROFILE_DISPLAY_FLUSH,          // A changed frame: draw and send the regions
+    PROFILE_JSON_ENCODE,            // Encoding the upload body (JSON or MessagePack)
+    PROFILE_HTTP_POST,              // One request including the TLS handshake if there is one
+    PROFILE_COMMAND,                // handleApiCommand()
+    PROFILE_LOOP,                   // One pass of the main loop without its sleep
+    PROFILE_ALARM_UPLOAD,           // An alarm sample taken to its upload delivered
+    PROFILE_POINTS
+};
+
+struct Histogram {
+    uint32_t buckets[PROFILE_BUCKETS];  // Not cumulative
+    uint32_t count;
+    uint64_t sumMicros;
+    uint32_t maxMicros;
+};
+
+namespace Profiler {
+    void record(ProfilePoint point, unsigned long elapsedMicros);  // Writer task of the point only
+    Histogram histogram(ProfilePoint point);                       // Consistent copy, any task
+    const char* pointName(ProfilePoint point);
+    size_t format(char* buffer, size_t size);  // Prometheus text; the length, 0 if it did not fit
+    void dump();                               // The same text over serial
+}
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(ProfilePoint point) : point(point), start(micros()) {}
+    ~ScopedTimer() { Profiler::record(point, micros() - start); }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    ProfilePoint point;
+    unsigned long start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#if PROFILING
+#define PROFILE_SCOPE(point) ScopedTimer PROFILE_CONCAT(profileTimer, __LINE__)(point)
+#else
+#define PROFILE_SCOPE(point) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * File: ReportPolicy.cpp
+ * Description: Upload decision, see ReportPolicy.h.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <math.h>
+
+#include "ReportPolicy.h"
+
+ReportReason ReportPolicy::check(const Sample& sample) {
+    ReportReason reason = REASON_NONE;
+    unsigned long elapsed = sample.timestamp - reportedAt;
+
+    if (!hasReported) {
+        reason = REASON_FIRST;
+    } else if (elapsed >= heartbeat) {
+        reason = REASON_HEARTBEAT;
+    } else if (elapsed >= minInterval) {
+        if (deadband > 0 && fabsf(sample.value - reportedValue) > deadband) {
+            reason = REASON_DEADBAND;
+        } else if (rateBand > 0 && hasPrevious && sample.timestamp != previous.timestamp) {
+            // Slope between two consecutive samples
+            float minutes = (sample.timestamp - previous.timestamp) / 60000.0f;
+            if (fabsf(sample.value - previous.value) / minutes > rateBand) {
+                reason = REASON_RATE;
+            }
+        }
+    }
+
+    previous = sample;
+    hasPrevious = true;
+    if (reason != REASON_NONE) {
+        hasReported = true;
+        reportedAt = sample.timestamp;
+        reportedValue = sample.value;
+    }
+    return reason;
+}
+
+const char* ReportPolicy::reasonName(ReportReason reason) {
+    switch (reason) {
+        case REASON_FIRST: return "first";
+        case REASON_HEARTBEAT: return "heartbeat";
+        case REASON_DEADBAND: return "deadband";
+        case REASON_RATE: return "rate";
+        default: return "none";
+    }
+}
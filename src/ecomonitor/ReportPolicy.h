@@ -0,0 +1,59 @@
+/*
+ * File: ReportPolicy.h
+ * Description: Decides after every sample whether a reading is uploaded. By default only the heartbeat (the
+ *              reading interval) does, which is the classic fixed-interval upload. With a deadband and/or a
+ *              rate-of-change band set, a reading is also uploaded as soon as the value moves away from the
+ *              last uploaded one by more than the deadband, or changes faster than the rate band; a flat signal
+ *              then costs one upload per heartbeat. Both bands are set with the change_deadband and
+ *              change_rate_band commands.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_REPORT_POLICY_H
+#define ECOMONITOR_REPORT_POLICY_H
+
+#include <Arduino.h>
+
+#include "Sampler.h"
+
+#ifndef REPORT_DEADBAND
+#define REPORT_DEADBAND 0       // In the unit of the measurement, 0 turns it off
+#endif
+#ifndef REPORT_RATE_BAND
+#define REPORT_RATE_BAND 0      // Units per minute, 0 turns it off
+#endif
+#ifndef REPORT_MIN_INTERVAL
+#define REPORT_MIN_INTERVAL 60000 // ms between two uploads triggered by the bands, keeps a noisy signal from flooding
+#endif
+
+enum ReportReason { REASON_NONE, REASON_FIRST, REASON_HEARTBEAT, REASON_DEADBAND, REASON_RATE };
+
+class ReportPolicy {
+public:
+    void setHeartbeat(unsigned long ms) { heartbeat = ms; }
+    void setDeadband(float band) { deadband = band; }
+    void setRateBand(float unitsPerMinute) { rateBand = unitsPerMinute; }
+    void setMinInterval(unsigned long ms) { minInterval = ms; }
+
+    void reset() { hasReported = false; hasPrevious = false; }  // The next sample is uploaded
+    ReportReason check(const Sample& sample);  // Anything but REASON_NONE: upload now, the sample counts as uploaded
+
+    static const char* reasonName(ReportReason reason);
+
+private:
+    unsigned long heartbeat = 15UL * 60UL * 1000UL;
+    float deadband = REPORT_DEADBAND;
+    float rateBand = REPORT_RATE_BAND;
+    unsigned long minInterval = REPORT_MIN_INTERVAL;
+
+    bool hasReported = false;
+    unsigned long reportedAt = 0;
+    float reportedValue = 0;
+    bool hasPrevious = false;
+    Sample previous = {0, 0, 0};
+};
+
+#endif
@@ -0,0 +1,41 @@
+/*
+ * File: RingBuffer.h
+ * Description: Fixed-capacity ring buffer. Storage is allocated inline, so it never touches the heap;
+ *              pushing into a full buffer overwrites the oldest element.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_RING_BUFFER_H
+#define ECOMONITOR_RING_BUFFER_H
+
+#include <stddef.h>
+
+template <typename T, size_t N>
+class RingBuffer {
+public:
+    void push(const T& item) {
+        items[head] = item;
+        head = (head + 1) % N;
+        if (count < N) count++;
+    }
+
+    // age 0 is the newest element, age size() - 1 the oldest
+    const T& newest(size_t age = 0) const { return items[(head + N - 1 - age) % N]; }
+    const T& oldest(size_t index = 0) const { return newest(count - 1 - index); }
+
+    size_t size() const { return count; }
+    bool isEmpty() const { return count == 0; }
+    bool isFull() const { return count == N; }
+    void clear() { head = 0; count = 0; }
+    static size_t capacity() { return N; }
+
+private:
+    T items[N];
+    size_t head = 0;
+    size_t count = 0;
+};
+
+#endif
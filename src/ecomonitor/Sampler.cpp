@@ -0,0 +1,64 @@
+/*
+ * File: Sampler.cpp
+ * Description: Single sampling engine, see Sampler.h.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include "Sampler.h"
+#include "Profiler.h"
+#include "hal/Hal.h"
+
+void Sampler::begin(SensorInterface* sensor) {
+    this->sensor = sensor;
+    history.clear();
+    channels.count = 0;
+    interval.reset();
+}
+
+const Sample& Sampler::sample() {
+    return keep(probe());
+}
+
+Sample Sampler::probe() {
+    Sample sample;
+    sample.timestamp = millis();
+    sample.epoch = Hal::clock().epoch();
+    {
+        PROFILE_SCOPE(PROFILE_SENSOR_READ);
+        sensor->readChannels(channels);
+    }
+    sample.value = channels.channels[0].value;
+    return sample;
+}
+
+const Sample& Sampler::keep(const Sample& sample) {
+    history.push(sample);
+    interval.add(sample.value);
+    return history.newest();
+}
+
+Reading Sampler::closeInterval() {
+    const Sample& last = latest();
+    if (interval.samples() == 0) {
+        interval.add(last.value);
+    }
+
+    Reading reading = {};
+    reading.timestamp = last.timestamp;
+    reading.epoch = last.epoch;
+    reading.value = last.value;
+    reading.min = interval.min();
+    reading.max = interval.max();
+    reading.mean = interval.mean();
+    reading.stddev = interval.stddev();
+    reading.count = interval.samples();
+    for (uint8_t i = 1; i < channels.count; i++) {
+        reading.channels[reading.channelCount++] = channels.channels[i];
+    }
+    if (interval.skipped() > 0) {
+        Serial.printf("%u failed sensor reads left out of the interval summary\n", (unsigned)interval.skipped());
+    }
+    interval.reset();
+    return reading;
+}
@@ -0,0 +1,70 @@
+/*
+ * File: Sampler.h
+ * Description: Single sampling engine. It is the only place that reads the sensor (one readChannels() call per
+ *              sample); the display, the serial log and the API upload all read the samples it keeps. The history
+ *              and the interval summary follow the device's own value; further channels of a multi-channel
+ *              sensor are kept from the latest sample and uploaded with the reading as they were last measured.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_SAMPLER_H
+#define ECOMONITOR_SAMPLER_H
+
+#include <Arduino.h>
+
+#include "IntervalStats.h"
+#include "RingBuffer.h"
+#include "sensors/SensorInterface.h"
+
+#ifndef SAMPLE_HISTORY_SIZE
+#define SAMPLE_HISTORY_SIZE 64 // 64 samples at the 5 s display rate is a bit over 5 minutes of history
+#endif
+
+struct Sample {
+    unsigned long timestamp; // millis() when the sample was taken
+    uint32_t epoch;          // Unix time of the sample, 0 if the clock was not synchronised yet
+    float value;
+};
+
+// Alarm state change a reading reports (Alarm.h); such a reading is uploaded at once, past the batch
+enum AlarmFlag : uint8_t { ALARM_FLAG_NONE, ALARM_FLAG_RAISED, ALARM_FLAG_CLEARED };
+
+// One reporting interval as it is uploaded: the last sample plus a summary of every sample taken in the interval
+struct Reading {
+    unsigned long timestamp; // millis() of the last sample
+    uint32_t epoch;          // Unix time of the last sample, 0 if the clock was not synchronised yet
+    float value;             // Last sample, uploaded as final_value
+    float min;
+    float max;
+    float mean;
+    float stddev;
+    uint16_t count;          // Samples in the interval
+    uint8_t channelCount;    // Further channels of the last sample, after value
+    Channel channels[SENSOR_MAX_CHANNELS - 1];
+    AlarmFlag alarm;         // Not kept in the journal, a replayed reading is an ordinary one
+};
+
+class Sampler {
+public:
+    void begin(SensorInterface* sensor);
+    const Sample& sample();                     // Take exactly one reading and store it
+    Sample probe();                             // Take one reading without storing it (the fast alarm samples)
+    const Sample& keep(const Sample& sample);   // Store a probed sample as if sample() had taken it
+    const Sample& latest() const { return history.newest(); }
+    const SensorReading& latestChannels() const { return channels; }  // All channels of the last reading taken
+    bool hasSamples() const { return !history.isEmpty(); }
+    const RingBuffer<Sample, SAMPLE_HISTORY_SIZE>& samples() const { return history; }
+    Reading closeInterval();                    // Summary of the samples since the last call, ending with latest()
+    uint16_t intervalSamples() const { return interval.samples(); }  // Samples closeInterval() would summarise
+
+private:
+    SensorInterface* sensor = nullptr;
+    RingBuffer<Sample, SAMPLE_HISTORY_SIZE> history;
+    SensorReading channels = {0, {}};
+    IntervalStats interval;
+};
+
+#endif
@@ -0,0 +1,122 @@
+/*
+ * File: Scheduler.cpp
+ * Description: Deadline scheduler of the main loop, see Scheduler.h.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include "Scheduler.h"
+
+void Scheduler::clear() {
+    count = 0;
+    idle = 0;
+}
+
+int Scheduler::add(const char* name, unsigned long periodMs, Job job) {
+    if (count >= SCHEDULER_MAX_JOBS || periodMs == 0) return -1;
+    uint8_t id = count;
+    Entry& entry = entries[id];
+    entry.job = job;
+    entry.deadline = micros();
+    entry.lastLate = 0;
+    entry.stats = {name, periodMs, 0, 0, 0, 0, 0, 0, 0};
+    heap[count++] = id;
+    siftUp(count - 1);
+    return id;
+}
+
+void Scheduler::runSoon(int id) {
+    if (id < 0 || (size_t)id >= count) return;
+    entries[id].deadline = micros();
+    for (size_t slot = 0; slot < count; slot++) {
+        if (heap[slot] == id) {
+            siftUp(slot);
+            siftDown(slot);
+            return;
+        }
+    }
+}
+
+void Scheduler::runDue() {
+    unsigned long now = micros();
+    while (count > 0) {
+        uint8_t id = heap[0];
+        Entry& entry = entries[id];
+        if ((long)(now - entry.deadline) < 0) break;
+
+        unsigned long start = micros();
+        long late = (long)(start - entry.deadline);
+        entry.job();
+        unsigned long elapsed = micros() - start;
+
+        JobStats& stats = entry.stats;
+        unsigned long jitter = stats.runs > 0 ? labs(late - entry.lastLate) : 0;
+        entry.lastLate = late;
+        stats.runs++;
+        stats.lateMicros += late;
+        if ((unsigned long)late > stats.maxLateMicros) stats.maxLateMicros = late;
+        if (jitter > stats.jitterMicros) stats.jitterMicros = jitter;
+        stats.runMicros += elapsed;
+        if (elapsed > stats.maxRunMicros) stats.maxRunMicros = elapsed;
+
+        // Fixed rate; deadlines that already passed again are skipped, so the job runs once in this pass
+        unsigned long period = stats.period * 1000UL;
+        entry.deadline += period;
+        if ((long)(now - entry.deadline) >= 0) {
+            unsigned long behind = (now - entry.deadline) / period + 1;
+            entry.deadline += behind * period;
+            stats.missed += behind;
+        }
+
+        // The job may have moved other deadlines, so it is not necessarily on top any more
+        for (size_t slot = 0; slot < count; slot++) {
+            if (heap[slot] == id) {
+                siftDown(slot);
+                break;
+            }
+        }
+    }
+}
+
+void Scheduler::sleep() {
+    unsigned long wait = SCHEDULER_MAX_IDLE * 1000UL;
+    if (count > 0) {
+        long untilNext = (long)(entries[heap[0]].deadline - micros());
+        if (untilNext <= 0) return;
+        if ((unsigned long)untilNext < wait) wait = untilNext;
+    }
+    unsigned long start = micros();
+    delay((wait + 999) / 1000);  // Rounded up, waking early would only mean another empty pass
+    idle += micros() - start;
+}
+
+// Heap order: the earlier deadline first, the job registered first on a tie
+bool Scheduler::later(uint8_t a, uint8_t b) const {
+    long difference = (long)(entries[a].deadline - entries[b].deadline);
+    return difference > 0 || (difference == 0 && a > b);
+}
+
+void Scheduler::siftUp(size_t slot) {
+    while (slot > 0) {
+        size_t parent = (slot - 1) / 2;
+        if (!later(heap[parent], heap[slot])) return;
+        uint8_t swap = heap[parent];
+        heap[parent] = heap[slot];
+        heap[slot] = swap;
+        slot = parent;
+    }
+}
+
+void Scheduler::siftDown(size_t slot) {
+    while (true) {
+        size_t earliest = slot;
+        size_t left = 2 * slot + 1, right = left + 1;
+        if (left < count && later(heap[earliest], heap[left])) earliest = left;
+        if (right < count && later(heap[earliest], heap[right])) earliest = right;
+        if (earliest == slot) return;
+        uint8_t swap = heap[earliest];
+        heap[earliest] = heap[slot];
+        heap[slot] = swap;
+        slot = earliest;
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ * File: Scheduler.h
+ * Description: Cooperative scheduler of the main loop. Every piece of periodic work (sampling, display, commands,
+ *              portal, housekeeping) is a job with a period and a deadline; the jobs sit in a min-heap ordered by
+ *              deadline, runDue() runs the ones that are due, earliest first, and sleep() blocks until the next
+ *              deadline, so the loop task is idle in between instead of polling. Deadlines advance at a fixed rate
+ *              (deadline += period), so a late run does not shift the following ones. A job that falls more than
+ *              a whole period behind skips the deadlines it missed, and every job runs at most once per pass.
+ *              Per job the scheduler records how late it started and how long it ran, so a slow job that
+ *              starves the others shows up as lateness of the others and run time of its own.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_SCHEDULER_H
+#define ECOMONITOR_SCHEDULER_H
+
+#include <Arduino.h>
+
+#define SCHEDULER_MAX_JOBS 8
+#define SCHEDULER_MAX_IDLE 1000     // ms sleep() waits at most, e.g. before any job is registered
+
+struct JobStats {
+    const char* name;
+    unsigned long period;           // ms
+    unsigned long runs;
+    unsigned long missed;           // Deadlines skipped because the job was a whole period late
+    unsigned long lateMicros;       // Start minus deadline, summed over the runs
+    unsigned long maxLateMicros;
+    unsigned long jitterMicros;     // Largest change of the lateness between two consecutive runs
+    unsigned long runMicros;        // Spent in the job
+    unsigned long maxRunMicros;
+};
+
+class Scheduler {
+public:
+    typedef void (*Job)();
+
+    void clear();                   // Drops all jobs and their statistics
+    int add(const char* name, unsigned long periodMs, Job job);  // First run at once, -1 when full
+    void runSoon(int id);           // Moves the deadline to now, e.g. when a job has fresh work
+    void runDue();
+    void sleep();                   // Until the next deadline
+
+    size_t jobs() const { return count; }
+    const JobStats& stats(int id) const { return entries[id].stats; }
+    unsigned long idleMicros() const { return idle; }  // Spent in sleep() since clear()
+
+private:
+    struct Entry {
+        Job job;
+        unsigned long deadline;     // micros(), compared as a signed difference so the wrap does not matter
+        long lastLate;
+        JobStats stats;
+    };
+
+    bool later(uint8_t a, uint8_t b) const;
+    void siftDown(size_t slot);
+    void siftUp(size_t slot);
+
+    Entry entries[SCHEDULER_MAX_JOBS];
+    uint8_t heap[SCHEDULER_MAX_JOBS];  // Job ids, the earliest deadline first
+    size_t count = 0;
+    unsigned long idle = 0;
+};
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * File: Screen.cpp
+ * Description: Retained-mode OLED rendering, see Screen.h.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include "Screen.h"
+#include "Profiler.h"
+
+static bool sameFrame(const ScreenFrame& a, const ScreenFrame& b) {
+    if (a.fieldCount != b.fieldCount || a.lineY != b.lineY) return false;
+    for (uint8_t i = 0; i < a.fieldCount; i++) {
+        const ScreenField& fa = a.fields[i];
+        const ScreenField& fb = b.fields[i];
+        if (fa.x != fb.x || fa.y != fb.y || fa.size != fb.size || strcmp(fa.text, fb.text) != 0) return false;
+    }
+    return true;
+}
+
+void Screen::begin() {
+    invalidate();
+    next = {0, -1, {}};
+    commit();
+}
+
+void Screen::text(int16_t x, int16_t y, uint8_t size, const char* text) {
+    if (next.fieldCount >= SCREEN_MAX_FIELDS) return;
+    ScreenField& field = next.fields[next.fieldCount++];
+    field.x = x;
+    field.y = y;
+    field.size = size;
+    strncpy(field.text, text, sizeof(field.text) - 1);
+    field.text[sizeof(field.text) - 1] = '\0';
+}
+
+void Screen::commit() {
+    if (panelKnown && sameFrame(next, shown)) {
+        frameStats.skipped++;
+        next = {0, -1, {}};
+        return;
+    }
+
+    unsigned long start = micros();
+    draw(next);
+    DisplayRegion regions[SCREEN_PAGES];
+    size_t count = collectRegions(regions);
+    size_t bytes = count > 0 ? display.sendRegions(regions, count) : 0;
+    unsigned long elapsed = micros() - start;
+    Profiler::record(PROFILE_DISPLAY_FLUSH, elapsed);
+
+    shown = next;
+    next = {0, -1, {}};
+    frameStats.frames++;
+    frameStats.bytes += bytes;
+    frameStats.micros += elapsed;
+    frameStats.lastBytes = bytes;
+    frameStats.lastMicros = elapsed;
+    if (elapsed > frameStats.maxMicros) frameStats.maxMicros = elapsed;
+}
+
+void Screen::draw(const ScreenFrame& frame) {
+    display.clear();
+    for (uint8_t i = 0; i < frame.fieldCount; i++) {
+        const ScreenField& field = frame.fields[i];
+        display.setTextSize(field.size);
+        display.setCursor(field.x, field.y);
+        display.print(field.text);
+    }
+    if (frame.lineY >= 0) display.drawLine(0, frame.lineY, SCREEN_WIDTH, frame.lineY);
+}
+
+// One region per page that differs from the panel, spanning the first to the last differing column. Gaps
+// inside a page are sent too: a second window costs 8 bytes of addressing, about as much as a short gap.
+size_t Screen::collectRegions(DisplayRegion* regions) {
+    const uint8_t* buffer = display.framebuffer();
+    size_t count = 0;
+    for (uint8_t page = 0; page < SCREEN_PAGES; page++) {
+        const uint8_t* drawn = buffer + page * SCREEN_WIDTH;
+        uint8_t* onPanel = panel + page * SCREEN_WIDTH;
+        int first = 0;
+        int last = SCREEN_WIDTH - 1;
+        if (panelKnown) {
+            while (first < SCREEN_WIDTH && drawn[first] == onPanel[first]) first++;
+            if (first == SCREEN_WIDTH) continue;
+            while (drawn[last] == onPanel[last]) last--;
+        }
+        memcpy(onPanel + first, drawn + first, last - first + 1);
+        regions[count++] = {page, (uint8_t)first, (uint8_t)last};
+    }
+    panelKnown = true;
+    return count;
+}
@@ -0,0 +1,77 @@
+/*
+ * File: Screen.h
+ * Description: Retained-mode layer over the OLED. A frame is described as a list of text fields (and the header
+ *              line) and only drawn when it differs from the frame on the panel, so the unchanged screens of the
+ *              5 s display refresh cost nothing. A changed frame is drawn into the framebuffer and compared with a
+ *              copy of what the panel shows; per page only the span of columns that differs is sent over I2C
+ *              instead of the whole 1 KB buffer.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_SCREEN_H
+#define ECOMONITOR_SCREEN_H
+
+#include <Arduino.h>
+
+#include "EcoMonitor.h"
+#include "hal/Hal.h"
+
+#define SCREEN_MAX_FIELDS 6
+#define SCREEN_FIELD_LENGTH 24
+#define SCREEN_PAGES (SCREEN_HEIGHT / 8)
+#define SCREEN_CHAR_WIDTH 6     // Pixels per character at text size 1, the built-in GFX font
+
+struct ScreenField {
+    int16_t x;
+    int16_t y;
+    uint8_t size;
+    char text[SCREEN_FIELD_LENGTH];
+};
+
+struct ScreenFrame {
+    uint8_t fieldCount;
+    int16_t lineY;              // Full-width horizontal line, -1 for none
+    ScreenField fields[SCREEN_MAX_FIELDS];
+};
+
+struct FrameStats {
+    unsigned long frames;       // Sent to the panel
+    unsigned long skipped;      // Identical to the frame on the panel, nothing drawn or sent
+    unsigned long bytes;        // On the bus, including addressing
+    unsigned long micros;       // Drawing, comparing and sending
+    unsigned long lastBytes;
+    unsigned long lastMicros;
+    unsigned long maxMicros;
+};
+
+class Screen {
+public:
+    explicit Screen(DisplayInterface& display) : display(display) {}
+
+    void begin();               // Clears the panel with one full frame
+    void invalidate() { panelKnown = false; }  // The panel content is unknown, the next frame is sent in full
+
+    // Build the next frame, then commit() it; fields past SCREEN_MAX_FIELDS or SCREEN_FIELD_LENGTH are cut off
+    void text(int16_t x, int16_t y, uint8_t size, const char* text);
+    void line(int16_t y) { next.lineY = y; }
+    void commit();
+
+    static int16_t textWidth(const char* text, uint8_t size) { return strlen(text) * SCREEN_CHAR_WIDTH * size; }
+    const FrameStats& stats() const { return frameStats; }
+
+private:
+    void draw(const ScreenFrame& frame);
+    size_t collectRegions(DisplayRegion* regions);
+
+    DisplayInterface& display;
+    ScreenFrame next = {0, -1, {}};
+    ScreenFrame shown = {0, -1, {}};
+    uint8_t panel[SCREEN_WIDTH * SCREEN_PAGES];    // What the panel shows
+    bool panelKnown = false;
+    FrameStats frameStats = {0, 0, 0, 0, 0, 0, 0};
+};
+
+#endif
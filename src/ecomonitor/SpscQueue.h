@@ -0,0 +1,53 @@
+/*
+ * File: SpscQueue.h
+ * Description: Bounded lock-free queue for exactly one producer task and one consumer task.
+ *              Storage is allocated inline; push() fails instead of blocking when the queue is full.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_SPSC_QUEUE_H
+#define ECOMONITOR_SPSC_QUEUE_H
+
+#include <stddef.h>
+#include <atomic>
+
+template <typename T, size_t N>
+class SpscQueue {
+public:
+    // Producer side only
+    bool push(const T& item) {
+        size_t current = head.load(std::memory_order_relaxed);
+        size_t next = (current + 1) % SLOTS;
+        if (next == tail.load(std::memory_order_acquire)) return false;
+        items[current] = item;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side only
+    bool pop(T& item) {
+        size_t current = tail.load(std::memory_order_relaxed);
+        if (current == head.load(std::memory_order_acquire)) return false;
+        item = items[current];
+        tail.store((current + 1) % SLOTS, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const {
+        return (head.load(std::memory_order_acquire) + SLOTS - tail.load(std::memory_order_acquire)) % SLOTS;
+    }
+    bool isEmpty() const { return size() == 0; }
+    static size_t capacity() { return N; }
+
+private:
+    static const size_t SLOTS = N + 1; // One slot stays free to tell a full queue from an empty one
+
+    T items[SLOTS];
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+};
+
+#endif
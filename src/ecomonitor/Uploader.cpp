@@ -0,0 +1,278 @@
+/*
+ * File: Uploader.cpp
+ * Description: Uploader task, see Uploader.h. Everything in this file except the functions marked as
+ *              main loop side runs on the uploader task.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <atomic>
+
+#include "Uploader.h"
+#include "EcoMonitor.h"
+#include "MqttChannel.h"
+#include "Payload.h"
+#include "Profiler.h"
+#include "RingBuffer.h"
+#include "SpscQueue.h"
+#include "hal/Hal.h"
+
+extern char device_id[];
+
+static HttpInterface& http = Hal::http();
+static NetworkInterface& network = Hal::network();
+
+static SpscQueue<Reading, UPLOAD_QUEUE_SIZE> readingQueue;    // Main loop -> uploader
+static SpscQueue<ApiCommand, COMMAND_QUEUE_SIZE> commandQueue; // Uploader -> main loop
+static std::atomic<unsigned long> batchSize(UPLOAD_BATCH_SIZE);
+static std::atomic<unsigned long> batchMaxAge(UPLOAD_BATCH_MAX_AGE * 60UL * 1000UL);
+static std::atomic<int> apiStatus(API_UNKNOWN);
+static std::atomic<unsigned long> droppedCount(0);
+static std::atomic<unsigned long> inFlight(0);  // Enqueued, neither uploaded nor in the journal yet
+static std::atomic<unsigned long> firstDelivery(0);
+static bool taskRunning = false;
+
+static RingBuffer<Reading, UPLOAD_BATCH_MAX> uploadBatch;
+static unsigned long lastDrainAttempt = 0;
+static unsigned long drainInterval = JOURNAL_DRAIN_INTERVAL;
+
+static std::atomic<int> encoding(UPLOAD_ENCODING);
+static bool batchEndpoint = true;   // Cleared when the server answers 404 to a batch
+
+enum PostResult { POST_DELIVERED, POST_RETRY, POST_REJECTED, POST_NOT_FOUND };
+
+// Request and response buffers. Nothing on the upload path allocates once the connection is open.
+static char readingsUrl[128];
+static char batchUrl[128];
+static uint8_t payload[UPLOAD_PAYLOAD_SIZE];
+static char responseBody[UPLOAD_RESPONSE_SIZE];
+
+// Moves the enqueued readings into the batch. A full batch is flushed before the next push, which would
+// overwrite its oldest reading; returns whether an alarm came in.
+static bool collectReadings() {
+    Reading reading;
+    bool urgent = false;
+    while (readingQueue.pop(reading)) {
+        urgent |= reading.alarm != ALARM_FLAG_NONE;
+        if (uploadBatch.isFull()) flushUploadBatch(urgent);
+        uploadBatch.push(reading);
+    }
+    return urgent;
+}
+
+namespace Uploader {
+    bool begin(bool withTask) {
+        snprintf(readingsUrl, sizeof(readingsUrl), "%s/sensor-readings/", getApiBaseUrl());
+        snprintf(batchUrl, sizeof(batchUrl), "%s/sensor-readings/batch/", getApiBaseUrl());
+        http.setTimeout(10000);
+        firstDelivery = 0;
+
+        if (taskRunning || !withTask) return taskRunning;
+        taskRunning = Hal::system().startTask("uploader", step, UPLOADER_PERIOD, UPLOADER_STACK_SIZE, UPLOADER_CORE);
+        if (!taskRunning) {
+            Serial.println("Uploader task could not be started, uploading from the main loop");
+        }
+        return taskRunning;
+    }
+
+    bool isTaskRunning() { return taskRunning; }
+
+    void step() {
+        bool urgent = collectReadings();
+        if (!uploadBatch.isEmpty() && (urgent || uploadBatch.size() >= batchSize
+            || millis() - uploadBatch.oldest().timestamp >= batchMaxAge)) {
+            flushUploadBatch(urgent);
+        }
+
+        drainJournal();
+    }
+
+    // A wake that ends in deep sleep cannot wait for the batch age or the pauses between journal batches
+    void uploadNow() {
+        flushUploadBatch(collectReadings());
+
+        Reading readings[UPLOAD_BATCH_MAX];
+        while (network.isConnected() && EcoMonitor::journal.pending() > 0) {
+            size_t count = EcoMonitor::journal.peek(readings, batchSize);
+            if (count == 0) break;
+            size_t sent = postReadings(readings, count);
+            EcoMonitor::journal.pop(sent);
+            if (sent < count) break;
+        }
+    }
+
+    bool enqueue(const Reading& reading) {
+        inFlight++;  // Before the push, the task may flush the reading right away
+        if (readingQueue.push(reading)) return true;
+        inFlight--;
+        droppedCount++;
+        return false;
+    }
+
+    bool nextCommand(ApiCommand& command) { return commandQueue.pop(command); }
+    void setBatchSize(unsigned long size) { batchSize = size; }
+    void setBatchMaxAge(unsigned long ms) { batchMaxAge = ms; }
+    void setEncoding(PayloadEncoding value) { encoding = value; }
+    ApiStatus status() { return (ApiStatus)apiStatus.load(); }
+    bool idle() { return inFlight == 0; }
+    unsigned long firstUploadAt() { return firstDelivery; }
+    unsigned long droppedReadings() { return droppedCount; }
+}
+
+// Time from the alarm sample to the server having it, the whole point of the alarm path
+static void recordAlarmLatency(const Reading* readings, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (readings[i].alarm != ALARM_FLAG_NONE) {
+            Profiler::record(PROFILE_ALARM_UPLOAD, (millis() - readings[i].timestamp) * 1000UL);
+        }
+    }
+}
+
+void flushUploadBatch(bool urgent) {
+    Reading readings[UPLOAD_BATCH_MAX];
+    size_t count = uploadBatch.size();
+    if (count == 0) return;
+    for (size_t i = 0; i < count; i++) {
+        readings[i] = uploadBatch.oldest(i);
+    }
+    uploadBatch.clear();
+
+    // While older readings are waiting in the journal, new ones queue up behind them to keep the order;
+    // an alarm does not wait for the backlog
+    size_t sent = !urgent && EcoMonitor::journal.pending() > 0 ? 0 : postReadings(readings, count);
+    recordAlarmLatency(readings, sent);
+    if (sent < count) {
+        for (size_t i = sent; i < count; i++) {
+            EcoMonitor::journal.append(readings[i]);
+        }
+        Serial.printf("Readings stored in journal, pending: %lu\n", (unsigned long)EcoMonitor::journal.pending());
+    }
+    inFlight -= count;
+}
+
+// Uploads the journal backlog one batch per call, oldest first, once the API is reachable again
+void drainJournal() {
+    if (EcoMonitor::journal.pending() == 0 || !network.isConnected()) return;
+    if (millis() - lastDrainAttempt < drainInterval) return;
+    lastDrainAttempt = millis();
+
+    Reading readings[UPLOAD_BATCH_MAX];
+    size_t count = EcoMonitor::journal.peek(readings, batchSize);
+    if (count == 0) return;
+
+    size_t sent = postReadings(readings, count);
+    EcoMonitor::journal.pop(sent);
+    drainInterval = sent == count ? JOURNAL_DRAIN_INTERVAL : JOURNAL_RETRY_INTERVAL;
+}
+
+// If the response carries a command, the main loop executes it
+static void readCommand(const HttpResponse& response) {
+    ApiCommand command;
+    if (!Payload::decodeCommand(response.body, response.length, response.contentType, command)) return;
+
+    Serial.print("Found command in response: ");
+    Serial.println(command.command);
+    if (!commandQueue.push(command)) {
+        Serial.println("Command queue full, command dropped");
+    }
+}
+
+static int postPayload(const char* url, PayloadEncoding format, size_t length, HttpResponse& response) {
+    PROFILE_SCOPE(PROFILE_HTTP_POST);
+    return http.post(url, Payload::contentType(format), payload, length, response);
+}
+
+// Only a 2xx delivers the readings. Transport and server errors, redirects, request timeouts (408) and rate
+// limits (429) are retried later; any other 4xx would be rejected again, so those readings are not kept.
+static PostResult classify(int httpCode) {
+    if (httpCode >= 200 && httpCode < 300) return POST_DELIVERED;
+    if (httpCode == 404) return POST_NOT_FOUND;
+    if (httpCode >= 400 && httpCode < 500 && httpCode != 408 && httpCode != 429) return POST_REJECTED;
+    return POST_RETRY;
+}
+
+// One request with the readings as its body
+static PostResult postRequest(const char* url, const Reading* readings, size_t count) {
+    Serial.print("Sending to: ");
+    Serial.println(url);
+
+    PayloadEncoding format = (PayloadEncoding)encoding.load();
+    size_t length = Payload::encodeReadings(device_id, readings, count, format, payload, sizeof(payload));
+    if (length == 0) {
+        Serial.println("Payload does not fit its buffer, readings dropped");
+        return POST_REJECTED;
+    }
+    MqttChannel::publishTelemetry(payload, length);
+    if (format == PAYLOAD_JSON) {
+        Serial.print("Payload: ");
+        Serial.println((const char*)payload);
+    } else {
+        Serial.printf("Payload: %u bytes %s\n", (unsigned)length, Payload::contentType(format));
+    }
+
+    Serial.println("Sending POST request...");
+    HttpResponse response = {responseBody, sizeof(responseBody), 0, ""};
+    bool reused = http.connected();
+    int httpCode = postPayload(url, format, length, response);
+    if (httpCode < 0 && reused) {
+        // The server closed the kept-alive connection while it was idle, try once more on a new one
+        EcoMonitor::connectionStats.staleRetries++;
+        http.disconnect();
+        reused = false;
+        httpCode = postPayload(url, format, length, response);
+    }
+    if (httpCode == 415 && format != PAYLOAD_JSON) {
+        // The server does not take the binary encoding: JSON until the next restart
+        Serial.println("Server rejected the binary payload, falling back to JSON");
+        encoding = PAYLOAD_JSON;
+        format = PAYLOAD_JSON;
+        length = Payload::encodeReadings(device_id, readings, count, format, payload, sizeof(payload));
+        if (length == 0) return POST_REJECTED;
+        httpCode = postPayload(url, format, length, response);
+    }
+    if (reused) EcoMonitor::connectionStats.reused++;
+    else EcoMonitor::connectionStats.fresh++;
+    PostResult result = classify(httpCode);
+    if (result == POST_DELIVERED && firstDelivery == 0) firstDelivery = millis();
+
+    if (httpCode > 0) {
+        Serial.printf("HTTP Code: %d, Response: ", httpCode);
+        if (Payload::encodingOf(response.contentType) == PAYLOAD_JSON) {
+            Serial.println(response.body);
+        } else {
+            Serial.printf("%u bytes %s\n", (unsigned)response.length, response.contentType);
+        }
+        apiStatus = API_ONLINE;
+        readCommand(response);
+        if (result == POST_REJECTED) Serial.printf("Server rejected %u readings, dropped\n", (unsigned)count);
+    } else {
+        Serial.print("HTTP POST failed: ");
+        Serial.println(http.errorToString(httpCode));
+        apiStatus = API_OFFLINE;
+    }
+
+    return result;
+}
+
+// A single reading goes to /sensor-readings/, several to /sensor-readings/batch/ as one request, or one by one
+// if the server has no batch endpoint. Returns how many readings, from the first, are done with (delivered or
+// rejected for good); the rest have to be kept for a retry.
+size_t postReadings(const Reading* readings, size_t count) {
+    if (!network.isConnected()) {
+        Serial.println("Cannot send data - Wi-Fi not connected");
+        apiStatus = API_OFFLINE; // Connection status is offline when can not connect to the API but Wi-Fi
+        return 0;
+    }
+
+    if (count > 1 && batchEndpoint) {
+        PostResult result = postRequest(batchUrl, readings, count);
+        if (result != POST_NOT_FOUND) return result == POST_RETRY ? 0 : count;
+        Serial.println("Server has no batch endpoint, sending readings one by one until the next restart");
+        batchEndpoint = false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        PostResult result = postRequest(readingsUrl, readings + i, 1);
+        if (result == POST_RETRY || result == POST_NOT_FOUND) return i;
+    }
+    return count;
+}
@@ -0,0 +1,79 @@
+/*
+ * File: Uploader.h
+ * Description: Network side of the device. A dedicated task, pinned to the core the Wi-Fi stack runs on, takes
+ *              readings from a lock-free queue, batches them, uploads them (or stores them in the journal) and
+ *              hands commands from the API responses back to the main loop through a second queue.
+ *              The main loop never waits on the network.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_UPLOADER_H
+#define ECOMONITOR_UPLOADER_H
+
+#include <Arduino.h>
+
+#include "Sampler.h"
+
+// Batch upload: readings are collected and sent together in one request once there are UPLOAD_BATCH_SIZE
+// of them or the oldest is UPLOAD_BATCH_MAX_AGE minutes old. A batch size of 1 uploads every reading on its own.
+// Both can be changed at runtime with the change_batch_size / change_batch_age commands.
+#ifndef UPLOAD_BATCH_SIZE
+#define UPLOAD_BATCH_SIZE 1
+#endif
+#ifndef UPLOAD_BATCH_MAX_AGE
+#define UPLOAD_BATCH_MAX_AGE 60
+#endif
+#define UPLOAD_BATCH_MAX 32
+
+// Encoding of the uploads: 0 JSON, 1 MessagePack (falls back to JSON if the server answers 415).
+// Can be changed at runtime with the change_encoding command ("json" / "msgpack").
+#ifndef UPLOAD_ENCODING
+#define UPLOAD_ENCODING 0
+#endif
+
+#define UPLOAD_QUEUE_SIZE 16
+#define COMMAND_QUEUE_SIZE 4
+#define UPLOADER_PERIOD 50          // ms between two passes of the uploader task
+#define UPLOADER_STACK_SIZE 8192
+#define UPLOADER_CORE 0             // Core the Wi-Fi stack runs on; loop() runs on core 1
+#define UPLOAD_CHANNEL_BYTES ((SENSOR_MAX_CHANNELS - 1) * 32)  // "channels" of a multi-channel sensor, per reading
+#define UPLOAD_PAYLOAD_SIZE (64 + UPLOAD_BATCH_MAX * (160 + UPLOAD_CHANNEL_BYTES)) // A full batch of readings with their summaries
+#define UPLOAD_JSON_POOL_SIZE (1024 + UPLOAD_BATCH_MAX * (256 + UPLOAD_CHANNEL_BYTES)) // Static arena for the request and response JSON documents
+#define UPLOAD_RESPONSE_SIZE 512    // Longer response bodies are cut off
+
+struct ApiCommand {
+    char command[32];
+    char payload[64];
+};
+
+enum ApiStatus { API_UNKNOWN, API_ONLINE, API_OFFLINE };
+
+enum PayloadEncoding { PAYLOAD_JSON, PAYLOAD_MSGPACK };
+
+namespace Uploader {
+    bool begin(bool withTask = true);       // Starts the task, or falls back to running step() from the main loop
+    bool isTaskRunning();
+    void step();                            // One pass of the uploader, normally run by its task
+    void uploadNow();                       // Without the task only: sends everything queued and the journal backlog at once
+
+    // Main loop side
+    bool enqueue(const Reading& reading);   // false if the queue is full and the reading was dropped
+    bool nextCommand(ApiCommand& command);
+    void setBatchSize(unsigned long size);
+    void setBatchMaxAge(unsigned long ms);
+    void setEncoding(PayloadEncoding encoding);
+    ApiStatus status();
+    bool idle();                            // Every enqueued reading has been uploaded or stored in the journal
+    unsigned long firstUploadAt();          // millis() of the first delivered upload since begin(), 0 until then
+    unsigned long droppedReadings();
+}
+
+// Uploader task side
+void flushUploadBatch(bool urgent = false);   // urgent: an alarm is in the batch, sent ahead of the journal
+size_t postReadings(const Reading* readings, size_t count);  // Readings done with, from the first
+void drainJournal();
+
+#endif
@@ -0,0 +1,244 @@
+/*
+ * File: Hal.h
+ * Description: Thin hardware abstraction layer. EcoMonitor and the sensors reach the hardware only through these
+ *              interfaces, so the same device logic runs on the ESP32 and on a Linux host with fake backends.
+ *              The ESP32 backends live in hal/esp32/, the host fakes in src/native/.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef ECOMONITOR_HAL_H
+#define ECOMONITOR_HAL_H
+
+#include <Arduino.h>
+#include <functional>
+
+class ClockInterface {
+public:
+    virtual unsigned long millis() = 0;
+    virtual unsigned long micros() = 0;
+    virtual void delay(unsigned long ms) = 0;
+    virtual void startTimeSync() = 0;  // Needs a network connection
+    virtual uint32_t epoch() = 0;      // Unix time in seconds, 0 until the time is known
+    virtual ~ClockInterface() {}
+};
+
+class AdcInterface {
+public:
+    virtual int read(uint8_t pin) = 0; // Raw 12-bit reading (0..4095)
+    virtual uint32_t readMilliVolts(uint8_t pin) = 0; // Reading corrected with the eFuse calibration
+    virtual ~AdcInterface() {}
+};
+
+// One page (8 pixel rows) of the panel, from firstColumn to lastColumn inclusive
+struct DisplayRegion {
+    uint8_t page;
+    uint8_t firstColumn;
+    uint8_t lastColumn;
+};
+
+class DisplayInterface {
+public:
+    virtual bool begin() = 0;
+    virtual void clear() = 0;
+    virtual void setTextSize(uint8_t size) = 0;
+    virtual void setCursor(int16_t x, int16_t y) = 0;
+    virtual void print(const char* text) = 0;
+    virtual void print(float value, int digits) = 0;
+    virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) = 0;
+    virtual const uint8_t* framebuffer() = 0;  // SSD1306 layout: SCREEN_WIDTH bytes per page, bit 0 is the top row
+    virtual size_t sendRegions(const DisplayRegion* regions, size_t count) = 0; // Bytes put on the bus
+    virtual void setPower(bool on) = 0;
+    virtual ~DisplayInterface() {}
+};
+
+// Key-value store (NVS on the ESP32)
+class StorageInterface {
+public:
+    virtual bool begin(const char* name) = 0;
+    virtual bool getBool(const char* key, bool defaultValue = false) = 0;
+    virtual void putBool(const char* key, bool value) = 0;
+    virtual String getString(const char* key, const String& defaultValue = String()) = 0;
+    virtual void putString(const char* key, const String& value) = 0;
+    virtual uint32_t getUInt(const char* key, uint32_t defaultValue = 0) = 0;
+    virtual void putUInt(const char* key, uint32_t value) = 0;
+    virtual float getFloat(const char* key, float defaultValue = 0) = 0;
+    virtual void putFloat(const char* key, float value) = 0;
+    virtual size_t getBytes(const char* key, void* buffer, size_t length) = 0;  // Bytes read, 0 if the key is missing
+    virtual void putBytes(const char* key, const void* value, size_t length) = 0;
+    virtual void remove(const char* key) = 0;   // A missing key is not an error
+    virtual void clear() = 0;
+    virtual ~StorageInterface() {}
+};
+
+// Fixed-size region of raw flash for append-style data (a data partition on the ESP32). Like NOR flash, write()
+// can only clear bits: a byte has to be erased (0xFF) before it is written, and erase() works on whole sectors.
+class BlockStoreInterface {
+public:
+    virtual bool begin(size_t size) = 0;
+    virtual bool read(size_t offset, void* data, size_t length) = 0;
+    virtual bool write(size_t offset, const void* data, size_t length) = 0;
+    virtual bool erase(size_t offset, size_t length) = 0;  // Sector aligned, sets the bytes back to 0xFF
+    virtual size_t sectorSize() = 0;
+    virtual ~BlockStoreInterface() {}
+};
+
+// Transport errors returned instead of a status code
+#define HTTP_ERROR_CONNECTION_REFUSED -1
+#define HTTP_ERROR_SEND_FAILED -2
+#define HTTP_ERROR_INVALID_URL -3
+#define HTTP_ERROR_INVALID_RESPONSE -7
+#define HTTP_ERROR_READ_TIMEOUT -11
+
+// The body is written into a buffer the caller owns; longer bodies are cut off but still read to the end
+struct HttpResponse {
+    char* body;             // Always NUL-terminated
+    size_t capacity;
+    size_t length;
+    char contentType[32];
+};
+
+// HTTP/1.1 POST on caller-provided buffers only. The connection stays open after a request when the server
+// allows it, so the next request to the same host skips the TCP connect and the TLS handshake.
+class HttpInterface {
+public:
+    // HTTP status code, or one of the negative HTTP_ERROR_ codes
+    virtual int post(const char* url, const char* contentType, const uint8_t* body, size_t length, HttpResponse& response) = 0;
+    virtual void setTimeout(uint16_t timeout) = 0;
+    virtual const char* errorToString(int code) = 0;
+    virtual bool connected() = 0;   // A kept-alive connection is open
+    virtual void disconnect() = 0;  // Drop the kept-alive connection
+    virtual ~HttpInterface() {}
+};
+
+// MQTT 3.1.1 client on a plain TCP connection (PubSubClient on the ESP32). Incoming messages are handed to the
+// handler from loop(), at most one per call, so the caller decides how many it takes in at a time.
+class MqttInterface {
+public:
+    // Returning false leaves the message unacknowledged: the client disconnects before the PUBACK goes out and the
+    // broker delivers the message again after the reconnect
+    typedef bool (*MessageHandler)(const char* topic, const uint8_t* payload, size_t length);
+
+    // Persistent session, so the broker keeps QoS 1 messages while the client is away. willMessage is published
+    // retained on willTopic if the connection drops without a disconnect.
+    virtual bool connect(const char* host, uint16_t port, const char* clientId, const char* willTopic,
+                         const char* willMessage) = 0;
+    virtual bool connected() = 0;
+    virtual void disconnect() = 0;
+    virtual bool subscribe(const char* topic) = 0;  // QoS 1
+    virtual bool publish(const char* topic, const uint8_t* payload, size_t length, bool retained) = 0;  // QoS 0
+    virtual void onMessage(MessageHandler handler) = 0;
+    virtual bool loop() = 0;    // Keep-alive and at most one incoming message; false once the connection is gone
+    virtual ~MqttInterface() {}
+};
+
+// Access point and address of the last connection. Handing it to startStation() skips the channel scan,
+// and with a non-zero ip also DHCP.
+struct StationHint {
+    uint8_t bssid[6];
+    uint8_t channel;        // 0: no hint
+    uint32_t ip;            // IPv4 addresses in network order, ip 0: use DHCP
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+};
+
+enum StationEvent { STATION_CONNECTED, STATION_DISCONNECTED };
+
+class NetworkInterface {
+public:
+    typedef void (*StationHandler)(StationEvent event);  // Called from the Wi-Fi task
+
+    virtual void startStation(const char* ssid, const char* password, const StationHint* hint = nullptr) = 0;
+    virtual bool stationHint(StationHint& hint) = 0;  // Of the current connection, false if not connected
+    virtual void onStationEvent(StationHandler handler) = 0;
+    virtual void startAccessPoint(const char* ssid, const char* password) = 0;
+    virtual bool isConnected() = 0;
+    virtual bool isStation() = 0;
+    virtual bool isAccessPoint() = 0;
+    virtual String localIP() = 0;
+    virtual String softAPIP() = 0;
+    virtual ~NetworkInterface() {}
+};
+
+// One HTTP request, only valid inside its handler
+class WebRequest {
+public:
+    virtual bool hasArg(const char* name) = 0;
+    virtual String arg(const char* name) = 0;
+    virtual void send(int code, const char* contentType, const char* content) = 0;
+    virtual void sendGzip(int code, const char* contentType, const uint8_t* data, size_t length) = 0; // Precompressed, in flash
+    virtual ~WebRequest() {}
+};
+
+// Handlers run on the server's own task (async_tcp on the ESP32), never on the loop
+class WebServerInterface {
+public:
+    typedef std::function<void(WebRequest&)> Handler;
+    typedef void (*StreamHandler)(uint32_t client, bool connected);
+
+    virtual void onGet(const char* uri, Handler handler) = 0;
+    virtual void onPost(const char* uri, Handler handler) = 0;
+    virtual void begin() = 0;
+
+    // One push channel to subscribers (a WebSocket on the ESP32); clients are identified by a non-zero id
+    virtual void openStream(const char* uri, StreamHandler handler) = 0;
+    virtual size_t streamQueued(uint32_t client) = 0;  // Messages not yet sent to the client
+    virtual void streamSend(uint32_t client, const char* text, size_t length) = 0;
+    virtual void streamClose(uint32_t client) = 0;
+    virtual ~WebServerInterface() {}
+};
+
+class SystemInterface {
+public:
+    // Runs step() every periodMs on its own task pinned to the given core; false if no task could be created
+    virtual bool startTask(const char* name, void (*step)(), unsigned long periodMs, uint32_t stackSize, int core) = 0;
+    virtual void restart() = 0;
+    virtual uint64_t efuseMac() = 0;
+    virtual uint32_t freeHeap() = 0;
+    virtual uint32_t minFreeHeap() = 0;       // Lowest free heap since boot
+    virtual uint32_t largestFreeBlock() = 0;  // Biggest single allocation that would still succeed
+    virtual uint32_t stackHighWater(const char* task) = 0;  // Bytes of the task's stack never used so far, 0 if unknown
+    virtual void deepSleep(uint64_t micros) = 0;  // Wakes on the RTC timer through a reset; RTC_DATA_ATTR data survives
+    virtual bool wokeFromSleep() = 0;         // This boot is a timer wake from deepSleep()
+    virtual ~SystemInterface() {}
+};
+
+// DS18B20 on the 1-Wire bus
+class TempProbeInterface {
+public:
+    virtual void begin() = 0;
+    virtual void setResolution(uint8_t bits) = 0;      // 9..12 bit
+    virtual void setWaitForConversion(bool wait) = 0;  // false: requestTemperatures() only starts the conversion
+    virtual void requestTemperatures() = 0;
+    virtual float getTempC() = 0;
+    virtual ~TempProbeInterface() {}
+};
+
+// AM2320 on I2C
+class HumidityProbeInterface {
+public:
+    virtual void begin() = 0;
+    virtual bool read(float& temperature, float& humidity) = 0;  // Both from one bus transaction; NAN on failure
+    virtual ~HumidityProbeInterface() {}
+};
+
+// Every platform defines these accessors once; the build selects which backend gets linked in.
+namespace Hal {
+    ClockInterface& clock();
+    AdcInterface& adc();
+    DisplayInterface& display();
+    StorageInterface& storage();
+    BlockStoreInterface& blockStore();
+    HttpInterface& http();
+    MqttInterface& mqtt();
+    NetworkInterface& network();
+    WebServerInterface& webServer();
+    SystemInterface& system();
+    TempProbeInterface& tempProbe();
+    HumidityProbeInterface& humidityProbe();
+}
+
+#endif
@@ -0,0 +1,543 @@
+/*
+ * File: Esp32Hal.cpp
+ * Description: ESP32 backends for the hardware abstraction layer. These are thin wrappers around the Arduino-ESP32 core
+ *              and the libraries from platformio.ini; no device logic belongs here.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <Wire.h>
+#include <WiFi.h>
+#include <ESPAsyncWebServer.h>
+#include <WiFiClientSecure.h>
+#include <PubSubClient.h>
+#include <Preferences.h>
+#include <esp_partition.h>
+#include <time.h>
+#include <esp_sleep.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+#include <OneWire.h>
+#include <DallasTemperature.h>
+#include <Adafruit_Sensor.h>
+#include <Adafruit_AM2320.h>
+
+#include "ecomonitor/hal/Hal.h"
+#include "ecomonitor/EcoMonitor.h"
+#include "ecomonitor/MqttChannel.h"
+#include "ecomonitor/sensors/DS18B20_Sensor.h"
+
+class Esp32Clock : public ClockInterface {
+public:
+    unsigned long millis() override { return ::millis(); }
+    unsigned long micros() override { return ::micros(); }
+    void delay(unsigned long ms) override { ::delay(ms); }
+    void startTimeSync() override { configTime(0, 0, "pool.ntp.org", "time.google.com"); }
+    uint32_t epoch() override {
+        time_t now = time(nullptr);
+        return now > 1600000000 ? (uint32_t)now : 0; // Before the first sync the clock counts from 1970
+    }
+};
+
+class Esp32Adc : public AdcInterface {
+public:
+    int read(uint8_t pin) override { return analogRead(pin); }
+    uint32_t readMilliVolts(uint8_t pin) override { return analogReadMilliVolts(pin); }
+};
+
+class Esp32Display : public DisplayInterface {
+public:
+    bool begin() override { return oled.begin(SSD1306_SWITCHCAPVCC, OLED_ADDR); }
+    void clear() override { oled.clearDisplay(); oled.setTextColor(WHITE); }
+    void setTextSize(uint8_t size) override { oled.setTextSize(size); }
+    void setCursor(int16_t x, int16_t y) override { oled.setCursor(x, y); }
+    void print(const char* text) override { oled.print(text); }
+    void print(float value, int digits) override { oled.print(value, digits); }
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) override { oled.drawLine(x0, y0, x1, y1, WHITE); }
+    const uint8_t* framebuffer() override { return oled.getBuffer(); }
+    size_t sendRegions(const DisplayRegion* regions, size_t count) override;
+    void setPower(bool on) override { oled.ssd1306_command(on ? SSD1306_DISPLAYON : SSD1306_DISPLAYOFF); }
+
+private:
+    Adafruit_SSD1306 oled{SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1, OLED_I2C_CLOCK, I2C_BUS_CLOCK};
+};
+
+// Adafruit_SSD1306::display() always sends the whole 1 KB buffer; this sets a page/column window and sends just
+// that slice. The panel is in horizontal addressing mode after begin(), so the data fills the window in order.
+size_t Esp32Display::sendRegions(const DisplayRegion* regions, size_t count) {
+    static const size_t DATA_CHUNK = I2C_BUFFER_LENGTH - 1;    // Wire's buffer minus the control byte
+    const uint8_t* buffer = oled.getBuffer();
+    size_t bytes = 0;
+
+    Wire.setClock(OLED_I2C_CLOCK);
+    for (size_t i = 0; i < count; i++) {
+        const DisplayRegion& region = regions[i];
+        Wire.beginTransmission(OLED_ADDR);
+        Wire.write((uint8_t)0x00);                      // Command stream
+        Wire.write((uint8_t)SSD1306_PAGEADDR);
+        Wire.write(region.page);
+        Wire.write(region.page);
+        Wire.write((uint8_t)SSD1306_COLUMNADDR);
+        Wire.write(region.firstColumn);
+        Wire.write(region.lastColumn);
+        Wire.endTransmission();
+        bytes += 8;
+
+        const uint8_t* data = buffer + region.page * SCREEN_WIDTH + region.firstColumn;
+        size_t length = region.lastColumn - region.firstColumn + 1;
+        while (length > 0) {
+            size_t chunk = length < DATA_CHUNK ? length : DATA_CHUNK;
+            Wire.beginTransmission(OLED_ADDR);
+            Wire.write((uint8_t)0x40);                  // Data stream
+            Wire.write(data, chunk);
+            Wire.endTransmission();
+            bytes += chunk + 2;
+            data += chunk;
+            length -= chunk;
+        }
+    }
+    Wire.setClock(I2C_BUS_CLOCK);
+    return bytes;
+}
+
+class Esp32Storage : public StorageInterface {
+public:
+    bool begin(const char* name) override { return prefs.begin(name, false); }
+    bool getBool(const char* key, bool defaultValue) override { return prefs.getBool(key, defaultValue); }
+    void putBool(const char* key, bool value) override { prefs.putBool(key, value); }
+    String getString(const char* key, const String& defaultValue) override { return prefs.getString(key, defaultValue); }
+    void putString(const char* key, const String& value) override { prefs.putString(key, value); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue) override { return prefs.getUInt(key, defaultValue); }
+    void putUInt(const char* key, uint32_t value) override { prefs.putUInt(key, value); }
+    float getFloat(const char* key, float defaultValue) override { return prefs.getFloat(key, defaultValue); }
+    void putFloat(const char* key, float value) override { prefs.putFloat(key, value); }
+    size_t getBytes(const char* key, void* buffer, size_t length) override {
+        return prefs.isKey(key) ? prefs.getBytes(key, buffer, length) : 0; // getBytes logs an error for a missing key
+    }
+    void putBytes(const char* key, const void* value, size_t length) override { prefs.putBytes(key, value, length); }
+    void remove(const char* key) override {
+        if (prefs.isKey(key)) prefs.remove(key);   // remove() logs an error for a missing key
+    }
+    void clear() override { prefs.clear(); }
+
+private:
+    Preferences prefs;
+};
+
+// The "journal" data partition of partitions.csv, written in place without a file system. The Journal erases
+// each sector before it fills it, so every sector sees one erase cycle per lap around the ring.
+class Esp32BlockStore : public BlockStoreInterface {
+public:
+    bool begin(size_t size) override {
+        partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "journal");
+        return partition != nullptr && partition->size >= size;
+    }
+    bool read(size_t offset, void* data, size_t length) override {
+        return partition && esp_partition_read(partition, offset, data, length) == ESP_OK;
+    }
+    bool write(size_t offset, const void* data, size_t length) override {
+        return partition && esp_partition_write(partition, offset, data, length) == ESP_OK;
+    }
+    bool erase(size_t offset, size_t length) override {
+        return partition && esp_partition_erase_range(partition, offset, length) == ESP_OK;
+    }
+    size_t sectorSize() override { return SPI_FLASH_SEC_SIZE; }
+
+private:
+    const esp_partition_t* partition = nullptr;
+};
+
+// Minimal HTTP/1.1 client over one long-lived connection. HTTPClient builds its request and response headers
+// in String objects on every call, this one only uses the fixed buffers below and the caller's response buffer.
+// Certificates are not verified, as before with HTTPClient::begin(url); WiFiClientSecure offers no TLS session
+// resumption, so reusing the connection is what saves the handshake.
+class Esp32Http : public HttpInterface {
+public:
+    Esp32Http() { secureClient.setInsecure(); }
+
+    int post(const char* url, const char* contentType, const uint8_t* body, size_t length, HttpResponse& response) override {
+        response.length = 0;
+        response.body[0] = '\0';
+        response.contentType[0] = '\0';
+
+        bool secure;
+        char host[64];
+        uint16_t port;
+        const char* path;
+        if (!parseUrl(url, secure, host, sizeof(host), port, path)) return HTTP_ERROR_INVALID_URL;
+
+        WiFiClient& client = secure ? static_cast<WiFiClient&>(secureClient) : plainClient;
+        if (active != &client || port != activePort || strcmp(host, activeHost) != 0 || !client.connected()) {
+            disconnect();
+            if (!client.connect(host, port)) return HTTP_ERROR_CONNECTION_REFUSED;
+            active = &client;
+            activePort = port;
+            strlcpy(activeHost, host, sizeof(activeHost));
+        }
+
+        int headerLength = snprintf(line, sizeof(line),
+            "POST %s HTTP/1.1\r\nHost: %s\r\nUser-Agent: EcoMonitor\r\nConnection: keep-alive\r\n"
+            "Content-Type: %s\r\nContent-Length: %u\r\n\r\n", path, host, contentType, (unsigned)length);
+        if (headerLength <= 0 || headerLength >= (int)sizeof(line)
+            || client.write((const uint8_t*)line, headerLength) != (size_t)headerLength
+            || client.write(body, length) != length) {
+            disconnect();
+            return HTTP_ERROR_SEND_FAILED;
+        }
+
+        int code = readResponse(client, response);
+        if (code < 0) disconnect();
+        return code;
+    }
+
+    void setTimeout(uint16_t timeout) override { timeoutMs = timeout; }
+
+    const char* errorToString(int code) override {
+        switch (code) {
+            case HTTP_ERROR_CONNECTION_REFUSED: return "connection refused";
+            case HTTP_ERROR_SEND_FAILED: return "send failed";
+            case HTTP_ERROR_INVALID_URL: return "invalid url";
+            case HTTP_ERROR_INVALID_RESPONSE: return "invalid response";
+            case HTTP_ERROR_READ_TIMEOUT: return "read Timeout";
+            default: return "unknown error";
+        }
+    }
+
+    bool connected() override { return active && active->connected(); }
+
+    void disconnect() override {
+        if (active) active->stop();
+        active = nullptr;
+    }
+
+private:
+    // http[s]://host[:port]/path, the path points into url
+    static bool parseUrl(const char* url, bool& secure, char* host, size_t hostSize, uint16_t& port, const char*& path) {
+        if (strncmp(url, "https://", 8) == 0) { secure = true; port = 443; url += 8; }
+        else if (strncmp(url, "http://", 7) == 0) { secure = false; port = 80; url += 7; }
+        else return false;
+
+        size_t hostLength = strcspn(url, ":/");
+        if (hostLength == 0 || hostLength >= hostSize) return false;
+        memcpy(host, url, hostLength);
+        host[hostLength] = '\0';
+        url += hostLength;
+
+        if (*url == ':') {
+            port = (uint16_t)strtoul(url + 1, (char**)&url, 10);
+        }
+        path = *url == '/' ? url : "/";
+        return true;
+    }
+
+    int readResponse(WiFiClient& client, HttpResponse& response) {
+        unsigned long deadline = millis() + timeoutMs;
+
+        // Status line: HTTP/1.1 201 Created
+        if (!readLine(client, deadline)) return HTTP_ERROR_READ_TIMEOUT;
+        int code = 0;
+        if (strncmp(line, "HTTP/1.", 7) != 0 || sscanf(line + 8, "%d", &code) != 1) return HTTP_ERROR_INVALID_RESPONSE;
+
+        long contentLength = -1;
+        bool chunked = false;
+        bool keepAlive = true;
+        for (;;) {
+            if (!readLine(client, deadline)) return HTTP_ERROR_READ_TIMEOUT;
+            if (line[0] == '\0') break;
+
+            const char* value = strchr(line, ':');
+            if (!value) continue;
+            value += strspn(value + 1, " ") + 1;
+            if (strncasecmp(line, "Content-Length:", 15) == 0) contentLength = atol(value);
+            else if (strncasecmp(line, "Transfer-Encoding:", 18) == 0) chunked = strcasestr(value, "chunked") != nullptr;
+            else if (strncasecmp(line, "Connection:", 11) == 0) keepAlive = strcasestr(value, "close") == nullptr;
+            else if (strncasecmp(line, "Content-Type:", 13) == 0) strlcpy(response.contentType, value, sizeof(response.contentType));
+        }
+
+        if (chunked) {
+            for (;;) {
+                if (!readLine(client, deadline)) return HTTP_ERROR_READ_TIMEOUT;
+                long chunkLength = strtol(line, nullptr, 16);
+                if (chunkLength <= 0) break;
+                if (!readBody(client, chunkLength, response, deadline) || !readLine(client, deadline)) return HTTP_ERROR_READ_TIMEOUT;
+            }
+            // Trailer headers end with an empty line
+            do {
+                if (!readLine(client, deadline)) return HTTP_ERROR_READ_TIMEOUT;
+            } while (line[0] != '\0');
+        } else if (contentLength >= 0) {
+            if (!readBody(client, contentLength, response, deadline)) return HTTP_ERROR_READ_TIMEOUT;
+        } else {
+            // No length given: the body ends when the server closes the connection
+            readBody(client, -1, response, deadline);
+            keepAlive = false;
+        }
+
+        if (!keepAlive) disconnect();
+        return code;
+    }
+
+    // One header line without the CRLF; longer lines are cut off at the size of the line buffer
+    bool readLine(WiFiClient& client, unsigned long deadline) {
+        size_t length = 0;
+        for (;;) {
+            int c = client.read();
+            if (c < 0) {
+                if (!client.connected() || (long)(millis() - deadline) >= 0) return false;
+                delay(1);
+                continue;
+            }
+            if (c == '\n') break;
+            if (c != '\r' && length < sizeof(line) - 1) line[length++] = (char)c;
+        }
+        line[length] = '\0';
+        return true;
+    }
+
+    // Reads length bytes, or everything until the connection closes if length is negative
+    bool readBody(WiFiClient& client, long length, HttpResponse& response, unsigned long deadline) {
+        uint8_t chunk[128];
+        while (length != 0) {
+            size_t wanted = length < 0 || length > (long)sizeof(chunk) ? sizeof(chunk) : (size_t)length;
+            int received = client.read(chunk, wanted);
+            if (received <= 0) {
+                if (!client.connected()) return length < 0;
+                if ((long)(millis() - deadline) >= 0) return false;
+                delay(1);
+                continue;
+            }
+            size_t stored = min((size_t)received, response.capacity - 1 - response.length);
+            memcpy(response.body + response.length, chunk, stored);
+            response.length += stored;
+            response.body[response.length] = '\0';
+            if (length > 0) length -= received;
+        }
+        return true;
+    }
+
+    WiFiClientSecure secureClient;
+    WiFiClient plainClient;
+    WiFiClient* active = nullptr;
+    char activeHost[64] = "";
+    uint16_t activePort = 0;
+    uint16_t timeoutMs = 10000;
+    char line[256];
+};
+
+// PubSubClient on its own WiFiClient, so the broker connection stays open next to the HTTP uploads. Its loop()
+// reads at most one packet per call and sends the PUBACK of a QoS 1 message after the handler has returned.
+class Esp32Mqtt : public MqttInterface {
+public:
+    Esp32Mqtt() : client(socket) {
+        // PubSubClient writes the PUBACK after the callback returns; on a closed socket that write goes nowhere
+        client.setCallback([this](char* topic, uint8_t* payload, unsigned int length) {
+            if (handler && !handler(topic, payload, length)) client.disconnect();
+        });
+    }
+
+    bool connect(const char* host, uint16_t port, const char* clientId, const char* willTopic,
+                 const char* willMessage) override {
+        // PubSubClient keeps the host pointer
+        strlcpy(broker, host, sizeof(broker));
+        client.setServer(broker, port);
+        client.setKeepAlive(MQTT_KEEPALIVE_SECONDS);
+        client.setSocketTimeout(MQTT_SOCKET_TIMEOUT_SECONDS);
+        client.setBufferSize(MQTT_PACKET_SIZE);
+        return client.connect(clientId, nullptr, nullptr, willTopic, 1, true, willMessage, false);
+    }
+
+    bool connected() override { return client.connected(); }
+    void disconnect() override { client.disconnect(); }
+    bool subscribe(const char* topic) override { return client.subscribe(topic, 1); }
+
+    bool publish(const char* topic, const uint8_t* payload, size_t length, bool retained) override {
+        return client.publish(topic, payload, length, retained);
+    }
+
+    void onMessage(MessageHandler messageHandler) override { handler = messageHandler; }
+    bool loop() override { return client.loop(); }
+
+private:
+    WiFiClient socket;
+    PubSubClient client;
+    MessageHandler handler = nullptr;
+    char broker[64] = "";
+};
+
+class Esp32Network : public NetworkInterface {
+public:
+    // Reconnects are left to the device logic, which backs off; the credentials are in our own NVS namespace already
+    void startStation(const char* ssid, const char* password, const StationHint* hint) override {
+        WiFi.persistent(false);
+        WiFi.mode(WIFI_STA);
+        WiFi.setAutoReconnect(false);
+        if (hint && hint->channel && hint->ip) {
+            WiFi.config(IPAddress(hint->ip), IPAddress(hint->gateway), IPAddress(hint->subnet), IPAddress(hint->dns));
+        } else {
+            WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+        }
+        if (hint && hint->channel) {
+            WiFi.begin(ssid, password, hint->channel, hint->bssid);
+        } else {
+            WiFi.begin(ssid, password);
+        }
+    }
+    bool stationHint(StationHint& hint) override {
+        if (WiFi.status() != WL_CONNECTED) return false;
+        memcpy(hint.bssid, WiFi.BSSID(), sizeof(hint.bssid));
+        hint.channel = WiFi.channel();
+        hint.ip = WiFi.localIP();
+        hint.gateway = WiFi.gatewayIP();
+        hint.subnet = WiFi.subnetMask();
+        hint.dns = WiFi.dnsIP();
+        return true;
+    }
+    void onStationEvent(StationHandler handler) override {
+        if (!stationHandler) {
+            WiFi.onEvent([](arduino_event_id_t event, arduino_event_info_t info) {
+                (void)info;
+                if (event == ARDUINO_EVENT_WIFI_STA_GOT_IP) stationHandler(STATION_CONNECTED);
+                else if (event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) stationHandler(STATION_DISCONNECTED);
+            });
+        }
+        stationHandler = handler;
+    }
+    void startAccessPoint(const char* ssid, const char* password) override {
+        WiFi.mode(WIFI_AP);
+        WiFi.softAP(ssid, password);
+    }
+    bool isConnected() override { return WiFi.status() == WL_CONNECTED; }
+    bool isStation() override { return WiFi.getMode() == WIFI_STA; }
+    bool isAccessPoint() override { return WiFi.getMode() == WIFI_MODE_AP; }
+    String localIP() override { return WiFi.localIP().toString(); }
+    String softAPIP() override { return WiFi.softAPIP().toString(); }
+
+private:
+    static StationHandler stationHandler;
+};
+
+NetworkInterface::StationHandler Esp32Network::stationHandler = nullptr;
+
+class Esp32WebRequest : public WebRequest {
+public:
+    explicit Esp32WebRequest(AsyncWebServerRequest* request) : request(request) {}
+    bool hasArg(const char* name) override { return request->hasArg(name); }
+    String arg(const char* name) override { return request->arg(name); }
+    void send(int code, const char* contentType, const char* content) override { request->send(code, contentType, content); }
+    void sendGzip(int code, const char* contentType, const uint8_t* data, size_t length) override {
+        AsyncWebServerResponse* response = request->beginResponse_P(code, contentType, data, length);
+        response->addHeader("Content-Encoding", "gzip");
+        request->send(response);
+    }
+
+private:
+    AsyncWebServerRequest* request;
+};
+
+class Esp32WebServer : public WebServerInterface {
+public:
+    void onGet(const char* uri, Handler handler) override { on(uri, HTTP_GET, handler); }
+    void onPost(const char* uri, Handler handler) override { on(uri, HTTP_POST, handler); }
+    void begin() override { server.begin(); }
+
+    void openStream(const char* uri, StreamHandler handler) override {
+        stream = new AsyncWebSocket(uri);   // Lives until the next restart, like the server
+        stream->onEvent([handler](AsyncWebSocket*, AsyncWebSocketClient* client, AwsEventType type, void*, uint8_t*, size_t) {
+            if (type == WS_EVT_CONNECT) handler(client->id(), true);
+            else if (type == WS_EVT_DISCONNECT) handler(client->id(), false);
+        });
+        server.addHandler(stream);
+    }
+    size_t streamQueued(uint32_t client) override {
+        AsyncWebSocketClient* found = stream ? stream->client(client) : nullptr;
+        return found ? found->queueLen() : 0;
+    }
+    void streamSend(uint32_t client, const char* text, size_t length) override { if (stream) stream->text(client, text, length); }
+    void streamClose(uint32_t client) override { if (stream) stream->close(client); }
+
+private:
+    void on(const char* uri, WebRequestMethodComposite method, Handler handler) {
+        server.on(uri, method, [handler](AsyncWebServerRequest* request) {
+            Esp32WebRequest wrapped(request);
+            handler(wrapped);
+        });
+    }
+
+    AsyncWebServer server{80};
+    AsyncWebSocket* stream = nullptr;
+};
+
+class Esp32System : public SystemInterface {
+public:
+    bool startTask(const char* name, void (*step)(), unsigned long periodMs, uint32_t stackSize, int core) override {
+        TaskSlot* slot = new TaskSlot{step, periodMs}; // Tasks run until the next restart, so is the slot
+        return xTaskCreatePinnedToCore(runTask, name, stackSize, slot, 1, nullptr, core) == pdPASS;
+    }
+    void restart() override { ESP.restart(); }
+    uint64_t efuseMac() override { return ESP.getEfuseMac(); }
+    uint32_t freeHeap() override { return ESP.getFreeHeap(); }
+    uint32_t minFreeHeap() override { return ESP.getMinFreeHeap(); }
+    uint32_t largestFreeBlock() override { return ESP.getMaxAllocHeap(); }
+    uint32_t stackHighWater(const char* task) override {
+        TaskHandle_t handle = xTaskGetHandle(task);
+        return handle ? uxTaskGetStackHighWaterMark(handle) * sizeof(StackType_t) : 0;
+    }
+    void deepSleep(uint64_t micros) override {
+        esp_sleep_enable_timer_wakeup(micros);
+        esp_deep_sleep_start();
+    }
+    bool wokeFromSleep() override { return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER; }
+
+private:
+    struct TaskSlot {
+        void (*step)();
+        unsigned long periodMs;
+    };
+
+    static void runTask(void* arg) {
+        TaskSlot* slot = (TaskSlot*)arg;
+        for (;;) {
+            slot->step();
+            vTaskDelay(pdMS_TO_TICKS(slot->periodMs));
+        }
+    }
+};
+
+class Esp32TempProbe : public TempProbeInterface {
+public:
+    void begin() override { sensors.begin(); }
+    void setResolution(uint8_t bits) override { sensors.setResolution(bits); }
+    void setWaitForConversion(bool wait) override { sensors.setWaitForConversion(wait); }
+    void requestTemperatures() override { sensors.requestTemperatures(); }
+    float getTempC() override { return sensors.getTempCByIndex(0); }
+
+private:
+    OneWire oneWire{ONE_WIRE_BUS};
+    DallasTemperature sensors{&oneWire};
+};
+
+class Esp32HumidityProbe : public HumidityProbeInterface {
+public:
+    void begin() override { am2320.begin(); }
+    bool read(float& temperature, float& humidity) override {
+        return am2320.readTemperatureAndHumidity(&temperature, &humidity);
+    }
+
+private:
+    Adafruit_AM2320 am2320;
+};
+
+namespace Hal {
+    ClockInterface& clock() { static Esp32Clock instance; return instance; }
+    AdcInterface& adc() { static Esp32Adc instance; return instance; }
+    DisplayInterface& display() { static Esp32Display instance; return instance; }
+    StorageInterface& storage() { static Esp32Storage instance; return instance; }
+    BlockStoreInterface& blockStore() { static Esp32BlockStore instance; return instance; }
+    HttpInterface& http() { static Esp32Http instance; return instance; }
+    MqttInterface& mqtt() { static Esp32Mqtt instance; return instance; }
+    NetworkInterface& network() { static Esp32Network instance; return instance; }
+    WebServerInterface& webServer() { static Esp32WebServer instance; return instance; }
+    SystemInterface& system() { static Esp32System instance; return instance; }
+    TempProbeInterface& tempProbe() { static Esp32TempProbe instance; return instance; }
+    HumidityProbeInterface& humidityProbe() { static Esp32HumidityProbe instance; return instance; }
+}
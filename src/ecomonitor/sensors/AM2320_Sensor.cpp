@@ -1,11 +1,22 @@
 #include <Arduino.h>
 #include "AM2320_Sensor.h"
-#include <Adafruit_Sensor.h>
-#include <Adafruit_AM2320.h>
+#include "ecomonitor/hal/Hal.h"
 
-Adafruit_AM2320 humidSensor = Adafruit_AM2320();
+void AM2320_Sensor::begin() {
+    Hal::humidityProbe().begin();
+}
 
 float AM2320_Sensor::readSensor() {
-    float final_value = humidSensor.readHumidity();
+    float temperature = NAN, final_value = NAN;
+    Hal::humidityProbe().read(temperature, final_value);
     return final_value;
 }
+
+// The AM2320 always returns both quantities, so one transaction gives the temperature for free
+void AM2320_Sensor::readChannels(SensorReading& reading) {
+    float temperature = NAN, humidity = NAN;
+    Hal::humidityProbe().read(temperature, humidity);
+    reading.count = 2;
+    reading.channels[0] = {CHANNEL_VALUE, humidity};
+    reading.channels[1] = {CHANNEL_TEMPERATURE, temperature};
+}
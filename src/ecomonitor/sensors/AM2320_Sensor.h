@@ -7,7 +7,9 @@
 
 class AM2320_Sensor : public SensorInterface {
 public:
+    void begin() override;
     float readSensor() override;
+    void readChannels(SensorReading& reading) override;  // Humidity, then temperature
 };
 
 #endif
\ No newline at end of file
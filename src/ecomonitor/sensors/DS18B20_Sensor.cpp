@@ -3,13 +3,50 @@
 //
 
 #include "DS18B20_Sensor.h"
+#include "ecomonitor/hal/Hal.h"
 
-DS18B20_Sensor::DS18B20_Sensor() {
-    tempSensors.begin();
+DS18B20_Sensor::DS18B20_Sensor(uint8_t resolution) {
+    if (resolution < 9) resolution = 9;
+    if (resolution > 12) resolution = 12;
+    this->resolution = resolution;
+}
+
+void DS18B20_Sensor::begin() {
+    TempProbeInterface& probe = Hal::tempProbe();
+    probe.begin();
+    probe.setResolution(resolution);
+
+    // Only the very first value is read synchronously, so the screen has something to show after boot
+    probe.setWaitForConversion(true);
+    probe.requestTemperatures();
+    harvest();
+
+    // The first read returns that value without starting another conversion, so a duty-cycle wake that
+    // samples once runs exactly one
+    probe.setWaitForConversion(false);
+    converting = false;
+    firstRead = true;
 }
 
 float DS18B20_Sensor::readSensor() {
-    tempSensors.requestTemperatures();
-    float final_value = tempSensors.getTempCByIndex(0);
-    return final_value;
-}
\ No newline at end of file
+    if (converting && millis() - conversionStarted >= conversionTime()) {
+        harvest();
+        converting = false;
+    }
+    if (!converting && !firstRead) startConversion();
+    firstRead = false;
+    return lastValue;
+}
+
+void DS18B20_Sensor::startConversion() {
+    Hal::tempProbe().requestTemperatures();
+    conversionStarted = millis();
+    converting = true;
+}
+
+void DS18B20_Sensor::harvest() {
+    float final_value = Hal::tempProbe().getTempC();
+    if (final_value > DS18B20_DISCONNECTED) { // Keep the previous value if the probe did not answer
+        lastValue = final_value;
+    }
+}
@@ -7,22 +7,38 @@
 #ifndef DS18B20_SENSOR_H
 #define DS18B20_SENSOR_H
 
-#include <OneWire.h>
-#include <DallasTemperature.h>
+#include <Arduino.h>
 
 #include "SensorInterface.h"
 
 #define ONE_WIRE_BUS 19 // Pin that DS18B20 connected to
 
+// Conversion resolution, 9..12 bit. Every bit less halves the conversion time (12 bit: 750 ms, 9 bit: 94 ms)
+// at the cost of precision (12 bit: 0.0625 °C steps, 9 bit: 0.5 °C steps).
+#ifndef DS18B20_RESOLUTION
+#define DS18B20_RESOLUTION 12
+#endif
+
+#define DS18B20_DISCONNECTED -127.0f // Value the library reports when the probe did not answer
+
+// Reads the DS18B20 without blocking the loop: a conversion runs in the background, readSensor()
+// returns the last finished value and only touches the bus once the conversion time has passed.
 class DS18B20_Sensor : public SensorInterface {
     public:
-        DS18B20_Sensor();
+        explicit DS18B20_Sensor(uint8_t resolution = DS18B20_RESOLUTION);
+        void begin() override;
         float readSensor() override;
-        void begin();
+        unsigned long conversionTime() const { return 750UL >> (12 - resolution); }
 
     private:
-        OneWire oneWire{ONE_WIRE_BUS};
-        DallasTemperature tempSensors{&oneWire};
+        void startConversion();
+        void harvest();
+
+        uint8_t resolution;
+        unsigned long conversionStarted = 0;
+        bool converting = false;
+        bool firstRead = false;     // begin() read a value that no readSensor() has returned yet
+        float lastValue = DS18B20_DISCONNECTED;
 };
 
-#endif
\ No newline at end of file
+#endif
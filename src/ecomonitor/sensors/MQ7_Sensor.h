@@ -3,15 +3,32 @@
 #ifndef MQ7_Sensor_H
 #define MQ7_Sensor_H
 
+#include <Arduino.h>
+
 #include "SensorInterface.h"
 
 #define MQ7_PIN 34
 #define RL 10
 #define RO_CLEAN_AIR 9.8
 
+// Every reading averages a burst of ADC conversions, which takes the noise of a single ESP32 sample out.
+#ifndef MQ7_OVERSAMPLING
+#define MQ7_OVERSAMPLING 64
+#endif
+
+// ppm curve lookup table, one entry every MQ7_TABLE_STEP_MV millivolts of sensor output
+#define MQ7_TABLE_STEP_MV 16
+#define MQ7_TABLE_MAX_MV 3328
+#define MQ7_TABLE_SIZE (MQ7_TABLE_MAX_MV / MQ7_TABLE_STEP_MV + 1)
+
 class MQ7_Sensor : public SensorInterface {
 public:
+    void begin() override;
     float readSensor() override;
+    float ppmFromMilliVolts(float milliVolts) const;
+
+private:
+    float ppmTable[MQ7_TABLE_SIZE];
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -10,10 +10,52 @@
 #ifndef SENSOR_INTERFACE_H
 #define SENSOR_INTERFACE_H
 
+#include <stdint.h>
+
+#ifndef SENSOR_MAX_CHANNELS
+#define SENSOR_MAX_CHANNELS 3
+#endif
+
+// What a channel measures. CHANNEL_VALUE is the device's own quantity, uploaded as final_value in getMeasurementUnit()
+enum ChannelId : uint8_t { CHANNEL_VALUE, CHANNEL_TEMPERATURE, CHANNEL_HUMIDITY };
+
+struct Channel {
+    ChannelId id;
+    float value;
+};
+
+// Every quantity of one measurement; channels[0] is always CHANNEL_VALUE, the value readSensor() returns
+struct SensorReading {
+    uint8_t count;
+    Channel channels[SENSOR_MAX_CHANNELS];
+};
+
+inline const char* channelName(ChannelId id) {  // Field name in the upload
+    switch (id) {
+        case CHANNEL_TEMPERATURE: return "temperature";
+        case CHANNEL_HUMIDITY: return "humidity";
+        default: return "final_value";
+    }
+}
+
+inline const char* channelUnit(ChannelId id) {  // nullptr for CHANNEL_VALUE, whose unit is the device's
+    switch (id) {
+        case CHANNEL_TEMPERATURE: return " °C";
+        case CHANNEL_HUMIDITY: return " % RH";
+        default: return nullptr;
+    }
+}
+
 class SensorInterface {
 public:
+    virtual void begin() {}
     virtual float readSensor() = 0;
+    // Sensors that measure more than one quantity override this and read all of them in one bus transaction
+    virtual void readChannels(SensorReading& reading) {
+        reading.count = 1;
+        reading.channels[0] = {CHANNEL_VALUE, readSensor()};
+    }
     virtual ~SensorInterface() {}
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -27,6 +27,5 @@ void setup() {
 }
 
 void loop() {
-    EcoMonitor::handleLoop();
-    delay(10);  // Small delay to prevent watchdog issues
+    EcoMonitor::handleLoop();  // Sleeps until the next job is due, which also lets the idle task feed the watchdog
 }
\ No newline at end of file
@@ -0,0 +1,70 @@
+/*
+ * File: Arduino.cpp
+ * Description: Host implementation of the Arduino stand-in. Timing is routed through the HAL clock,
+ *              so delay() advances the fake clock instead of sleeping.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <Arduino.h>
+#include <ctype.h>
+#include <stdarg.h>
+
+#include "ecomonitor/hal/Hal.h"
+
+HardwareSerial Serial;
+
+unsigned long millis() { return Hal::clock().millis(); }
+unsigned long micros() { return Hal::clock().micros(); }
+void delay(unsigned long ms) { Hal::clock().delay(ms); }
+
+static std::string formatInteger(unsigned long long number, bool negative, unsigned char base) {
+    if (base < 2 || base > 16) base = DEC;
+    char digits[66];
+    int pos = sizeof(digits) - 1;
+    digits[pos] = '\0';
+    do {
+        digits[--pos] = "0123456789abcdef"[number % base];
+        number /= base;
+    } while (number > 0);
+    if (negative) digits[--pos] = '-';
+    return std::string(digits + pos);
+}
+
+String::String(int number, unsigned char base)
+    : value(base == DEC ? formatInteger(number < 0 ? -(long long)number : number, number < 0, base)
+                        : formatInteger((unsigned int)number, false, base)) {}
+String::String(unsigned int number, unsigned char base) : value(formatInteger(number, false, base)) {}
+String::String(long number, unsigned char base)
+    : value(base == DEC ? formatInteger(number < 0 ? -(long long)number : number, number < 0, base)
+                        : formatInteger((unsigned long)number, false, base)) {}
+String::String(unsigned long number, unsigned char base) : value(formatInteger(number, false, base)) {}
+String::String(float number, unsigned int decimals) : String((double)number, decimals) {}
+
+String::String(double number, unsigned int decimals) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, number);
+    value = buffer;
+}
+
+void String::toUpperCase() {
+    for (char& c : value) c = (char)toupper((unsigned char)c);
+}
+
+size_t HardwareSerial::print(const char* text) {
+    if (quiet) return strlen(text);
+    return fwrite(text, 1, strlen(text), stdout);
+}
+
+size_t HardwareSerial::print(char c) {
+    if (quiet) return 1;
+    return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int written = quiet ? vsnprintf(nullptr, 0, format, args) : vprintf(format, args);
+    va_end(args);
+    return written < 0 ? 0 : (size_t)written;
+}
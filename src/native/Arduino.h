@@ -0,0 +1,114 @@
+/*
+ * File: Arduino.h
+ * Description: Minimal host stand-in for the Arduino core, used only by the [env:native] build.
+ *              It covers the small part of the core that EcoMonitor uses directly (String, Serial, timing);
+ *              everything hardware-related goes through hal/Hal.h instead.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+
+#define DEC 10
+#define HEX 16
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+#define F(string_literal) (string_literal)
+#define PROGMEM
+#define RTC_DATA_ATTR   // A static already outlives the simulated deep sleep on the host
+
+// Part of newlib on the ESP32, but only of glibc since 2.38
+#if defined(__GLIBC__) && __GLIBC__ == 2 && __GLIBC_MINOR__ < 38
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+    size_t length = strlen(src);
+    if (size > 0) {
+        size_t n = length < size - 1 ? length : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return length;
+}
+#endif
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+inline void yield() {}
+
+class String {
+public:
+    String() {}
+    String(const char* text) : value(text ? text : "") {}
+    String(const std::string& text) : value(text) {}
+    String(char c) : value(1, c) {}
+    String(int number, unsigned char base = DEC);
+    String(unsigned int number, unsigned char base = DEC);
+    String(long number, unsigned char base = DEC);
+    String(unsigned long number, unsigned char base = DEC);
+    String(float number, unsigned int decimals = 2);
+    String(double number, unsigned int decimals = 2);
+
+    const char* c_str() const { return value.c_str(); }
+    unsigned int length() const { return value.length(); }
+    bool isEmpty() const { return value.empty(); }
+    void reserve(unsigned int size) { value.reserve(size); }
+    long toInt() const { return strtol(value.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(value.c_str(), nullptr); }
+    void toUpperCase();
+
+    String& operator+=(const String& other) { value += other.value; return *this; }
+    String& operator+=(const char* other) { value += other; return *this; }
+    String& operator+=(char c) { value += c; return *this; }
+    bool operator==(const String& other) const { return value == other.value; }
+    bool operator==(const char* other) const { return value == other; }
+    bool operator!=(const String& other) const { return value != other.value; }
+    bool operator!=(const char* other) const { return value != other; }
+
+private:
+    std::string value;
+};
+
+inline String operator+(const String& lhs, const String& rhs) { String result(lhs); result += rhs; return result; }
+inline String operator+(const String& lhs, const char* rhs) { String result(lhs); result += rhs; return result; }
+inline String operator+(const char* lhs, const String& rhs) { String result(lhs); result += rhs; return result; }
+
+class HardwareSerial {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void setQuiet(bool quiet) { this->quiet = quiet; }
+
+    size_t print(const char* text);
+    size_t print(const String& text) { return print(text.c_str()); }
+    size_t print(char c);
+    size_t print(int number, int base = DEC) { return print(String(number, base)); }
+    size_t print(unsigned int number, int base = DEC) { return print(String(number, base)); }
+    size_t print(long number, int base = DEC) { return print(String(number, base)); }
+    size_t print(unsigned long number, int base = DEC) { return print(String(number, base)); }
+    size_t print(double number, int digits = 2) { return print(String(number, digits)); }
+
+    size_t println() { return print("\n"); }
+    template <typename T> size_t println(const T& value) { size_t n = print(value); return n + println(); }
+    template <typename T> size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    void flush() {}
+
+private:
+    bool quiet = false;
+};
+
+extern HardwareSerial Serial;
+
+#endif
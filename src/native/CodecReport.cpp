@@ -0,0 +1,238 @@
+/*
+ * File: CodecReport.cpp
+ * Description: Host check of the upload encodings (program --codec FILE...). Every reading of the exported
+ *              datasets is encoded as JSON and as MessagePack, one per request and in full batches, decoded
+ *              back and compared; the byte counts of both encodings are printed side by side. Hourly summaries
+ *              of the readings (count/min/max/mean/stddev) and command responses are round-tripped the same way.
+ *              The raw (epoch, value) series also goes through the Gorilla blocks of Gorilla.h, at the size of the
+ *              deep-sleep buffer and of a flash sector, with the compression ratio and the encode/decode time per
+ *              value. Exits with 1 if anything did not survive the round trip.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <ArduinoJson.h>
+#include <chrono>
+#include <math.h>
+#include <vector>
+
+#include "CodecReport.h"
+#include "Dataset.h"
+#include "ecomonitor/DutyCycle.h"
+#include "ecomonitor/Gorilla.h"
+#include "ecomonitor/IntervalStats.h"
+#include "ecomonitor/Payload.h"
+
+static const char* DEVICE_ID = "GG-4085A0A5";
+static const size_t GORILLA_FLASH_BLOCK = 4096;     // One flash sector
+static const int GORILLA_ROUNDS = 200;              // The traces are short, so the timings are averaged over rounds
+static const size_t RAW_SAMPLE_SIZE = 8;            // uint32_t epoch + float value
+
+struct EncodingTotals {
+    unsigned long bytes = 0;
+    unsigned long mismatches = 0;
+};
+
+// MessagePack carries the float itself; the JSON text only has to come back within its printed precision
+static bool sameValue(float decoded, float original, PayloadEncoding encoding) {
+    if (encoding == PAYLOAD_MSGPACK) return decoded == original;
+    return fabsf(decoded - original) <= 1e-6f * fmaxf(1.0f, fabsf(original));
+}
+
+static bool sameReading(JsonVariant decoded, const Reading& reading, PayloadEncoding encoding) {
+    bool same = sameValue(decoded["final_value"] | NAN, reading.value, encoding)
+        && (decoded["timestamp"] | 0UL) == reading.epoch;
+    if (same && reading.count > 1) {
+        same = (decoded["count"] | 0U) == reading.count
+            && sameValue(decoded["min"] | NAN, reading.min, encoding)
+            && sameValue(decoded["max"] | NAN, reading.max, encoding)
+            && sameValue(decoded["mean"] | NAN, reading.mean, encoding)
+            && sameValue(decoded["stddev"] | NAN, reading.stddev, encoding);
+    }
+    return same;
+}
+
+// Every exported value as a reading of its own
+static std::vector<Reading> toReadings(const std::vector<Sample>& samples) {
+    std::vector<Reading> readings;
+    for (const Sample& sample : samples) {
+        readings.push_back({sample.timestamp, sample.epoch, sample.value, sample.value, sample.value, sample.value, 0.0f, 1, 0, {}, ALARM_FLAG_NONE});
+    }
+    return readings;
+}
+
+// The exported values summarised per hour, as the device does per reporting interval
+static std::vector<Reading> toHourlySummaries(const std::vector<Sample>& samples) {
+    std::vector<Reading> readings;
+    IntervalStats stats;
+    for (size_t i = 0; i < samples.size(); i++) {
+        stats.add(samples[i].value);
+        bool last = i + 1 == samples.size();
+        if (last || samples[i + 1].epoch / 3600 != samples[i].epoch / 3600) {
+            readings.push_back({samples[i].timestamp, samples[i].epoch, samples[i].value,
+                                stats.min(), stats.max(), stats.mean(), stats.stddev(), stats.samples(), 0, {}, ALARM_FLAG_NONE});
+            stats.reset();
+        }
+    }
+    return readings;
+}
+
+static bool roundTrip(const Reading* readings, size_t count, PayloadEncoding encoding, EncodingTotals& totals) {
+    static uint8_t buffer[UPLOAD_PAYLOAD_SIZE];
+    size_t length = Payload::encodeReadings(DEVICE_ID, readings, count, encoding, buffer, sizeof(buffer));
+    totals.bytes += length;
+
+    JsonDocument doc;
+    DeserializationError error = encoding == PAYLOAD_MSGPACK ? deserializeMsgPack(doc, buffer, length)
+                                                             : deserializeJson(doc, (const char*)buffer, length);
+    bool same = length > 0 && !error && strcmp(doc["device_id"] | "", DEVICE_ID) == 0;
+    if (same && count == 1) {
+        same = sameReading(doc.as<JsonVariant>(), readings[0], encoding);
+    } else if (same) {
+        JsonArray list = doc["readings"].as<JsonArray>();
+        same = list.size() == count;
+        for (size_t i = 0; same && i < count; i++) {
+            same = sameReading(list[i], readings[i], encoding);
+        }
+    }
+    if (!same) totals.mismatches++;
+    return same;
+}
+
+static bool commandRoundTrip(PayloadEncoding encoding) {
+    JsonDocument doc;
+    doc["command"] = "change_reading_time";
+    doc["payload"] = "5";
+    doc["id"] = 17;             // Fields the device does not know about are skipped by the filter
+    char body[128];
+    size_t length = encoding == PAYLOAD_MSGPACK ? serializeMsgPack(doc, body, sizeof(body))
+                                                : serializeJson(doc, body, sizeof(body));
+
+    ApiCommand command;
+    return Payload::decodeCommand(body, length, Payload::contentType(encoding), command)
+        && strcmp(command.command, "change_reading_time") == 0 && strcmp(command.payload, "5") == 0;
+}
+
+struct GorillaTotals {
+    unsigned long blocks = 0;
+    unsigned long bytes = 0;
+    unsigned long mismatches = 0;
+    double encodeSeconds = 0;
+    double decodeSeconds = 0;
+};
+
+// The whole series into consecutive blocks of blockSize bytes, as a buffer in RAM or flash would hold it
+static GorillaTotals gorillaRoundTrip(const std::vector<Sample>& samples, size_t blockSize) {
+    GorillaTotals totals;
+    std::vector<uint8_t> storage(blockSize * samples.size());
+    std::vector<GorillaState> states(samples.size());
+    std::vector<uint32_t> epochs(samples.size());
+    std::vector<float> values(samples.size());
+    size_t used = 0, decoded = 0;
+
+    for (int round = 0; round < GORILLA_ROUNDS; round++) {
+        auto start = std::chrono::steady_clock::now();
+        used = 0;
+        states[0] = {};
+        for (const Sample& sample : samples) {
+            if (!Gorilla::append(states[used], &storage[used * blockSize], blockSize, sample.epoch, sample.value)) {
+                states[++used] = {};
+                Gorilla::append(states[used], &storage[used * blockSize], blockSize, sample.epoch, sample.value);
+            }
+        }
+        used++;
+        auto middle = std::chrono::steady_clock::now();
+        decoded = 0;
+        for (size_t block = 0; block < used; block++) {
+            GorillaReader reader(&storage[block * blockSize], Gorilla::length(states[block]));
+            while (decoded < samples.size() && reader.next(epochs[decoded], values[decoded])) decoded++;
+        }
+        auto end = std::chrono::steady_clock::now();
+        totals.encodeSeconds += std::chrono::duration<double>(middle - start).count();
+        totals.decodeSeconds += std::chrono::duration<double>(end - middle).count();
+    }
+
+    totals.blocks = used;
+    for (size_t block = 0; block < used; block++) totals.bytes += Gorilla::length(states[block]);
+    // Bit for bit, unlike the JSON text
+    totals.mismatches = samples.size() - decoded;
+    for (size_t i = 0; i < decoded; i++) {
+        if (epochs[i] != samples[i].epoch || memcmp(&values[i], &samples[i].value, sizeof(float)) != 0) {
+            totals.mismatches++;
+        }
+    }
+    return totals;
+}
+
+static void printGorillaRow(size_t blockSize, const GorillaTotals& totals, size_t values) {
+    char name[32];
+    snprintf(name, sizeof(name), "gorilla %u B", (unsigned)blockSize);
+    double perValue = 1e9 / GORILLA_ROUNDS / values;
+    printf("  %-18s %lu blocks, %5lu bytes (%4.2f per value, %4.1fx raw), encode %.0f ns, decode %.0f ns per value\n",
+           name, totals.blocks, totals.bytes, (double)totals.bytes / values,
+           (double)values * RAW_SAMPLE_SIZE / totals.bytes, totals.encodeSeconds * perValue,
+           totals.decodeSeconds * perValue);
+}
+
+// Bytes per exported value, so the rows compare what the same data costs on the wire
+static void printRow(const char* name, const EncodingTotals* totals, size_t values) {
+    printf("  %-18s json %7lu bytes (%5.1f per value), msgpack %7lu bytes (%5.1f per value, %.0f%%)\n", name,
+           totals[PAYLOAD_JSON].bytes, (double)totals[PAYLOAD_JSON].bytes / values,
+           totals[PAYLOAD_MSGPACK].bytes, (double)totals[PAYLOAD_MSGPACK].bytes / values,
+           100.0 * totals[PAYLOAD_MSGPACK].bytes / totals[PAYLOAD_JSON].bytes);
+}
+
+int runCodecReport(const std::vector<const char*>& paths) {
+    unsigned long failures = 0;
+
+    for (const char* path : paths) {
+        std::vector<Sample> samples;
+        if (!loadDataset(path, samples)) {
+            fprintf(stderr, "Cannot read dataset %s\n", path);
+            return 2;
+        }
+
+        std::vector<Reading> readings = toReadings(samples);
+        std::vector<Reading> summaries = toHourlySummaries(samples);
+
+        EncodingTotals single[2], batched[2], summarised[2];
+        for (int encoding = PAYLOAD_JSON; encoding <= PAYLOAD_MSGPACK; encoding++) {
+            for (size_t i = 0; i < readings.size(); i++) {
+                roundTrip(&readings[i], 1, (PayloadEncoding)encoding, single[encoding]);
+            }
+            for (size_t i = 0; i < readings.size(); i += UPLOAD_BATCH_MAX) {
+                size_t count = std::min((size_t)UPLOAD_BATCH_MAX, readings.size() - i);
+                roundTrip(&readings[i], count, (PayloadEncoding)encoding, batched[encoding]);
+            }
+            for (size_t i = 0; i < summaries.size(); i++) {
+                roundTrip(&summaries[i], 1, (PayloadEncoding)encoding, summarised[encoding]);
+            }
+            failures += single[encoding].mismatches + batched[encoding].mismatches + summarised[encoding].mismatches;
+        }
+
+        GorillaTotals sleepBlocks = gorillaRoundTrip(samples, SLEEP_BUFFER_BYTES);
+        GorillaTotals flashBlocks = gorillaRoundTrip(samples, GORILLA_FLASH_BLOCK);
+        failures += sleepBlocks.mismatches + flashBlocks.mismatches;
+
+        size_t n = readings.size();
+        printf("%s: %u readings, %u hourly summaries\n", path, (unsigned)n, (unsigned)summaries.size());
+        printRow("one per request", single, n);
+        printRow("full batches", batched, n);
+        printRow("hourly summaries", summarised, n);
+        printf("  round trip:        json %lu mismatches, msgpack %lu mismatches\n",
+               single[PAYLOAD_JSON].mismatches + batched[PAYLOAD_JSON].mismatches + summarised[PAYLOAD_JSON].mismatches,
+               single[PAYLOAD_MSGPACK].mismatches + batched[PAYLOAD_MSGPACK].mismatches
+               + summarised[PAYLOAD_MSGPACK].mismatches);
+        printGorillaRow(SLEEP_BUFFER_BYTES, sleepBlocks, n);
+        printGorillaRow(GORILLA_FLASH_BLOCK, flashBlocks, n);
+        printf("  gorilla round trip: %lu mismatches\n", sleepBlocks.mismatches + flashBlocks.mismatches);
+    }
+
+    for (int encoding = PAYLOAD_JSON; encoding <= PAYLOAD_MSGPACK; encoding++) {
+        bool ok = commandRoundTrip((PayloadEncoding)encoding);
+        printf("command response (%s): %s\n", Payload::contentType((PayloadEncoding)encoding), ok ? "ok" : "MISMATCH");
+        if (!ok) failures++;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,17 @@
+/*
+ * File: CodecReport.h
+ * Description: Round trip and size comparison of the upload encodings on exported datasets, see CodecReport.cpp.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef NATIVE_CODEC_REPORT_H
+#define NATIVE_CODEC_REPORT_H
+
+#include <vector>
+
+int runCodecReport(const std::vector<const char*>& paths);  // Process exit code
+
+#endif
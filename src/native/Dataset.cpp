@@ -0,0 +1,65 @@
+/*
+ * File: Dataset.cpp
+ * Description: Loader for the exported readings, see Dataset.h. The JSON export is an array of
+ *              {"created_at": "2026-01-11T21:14:47.301647+00:00", "final_value": 0.700571}, the CSV export
+ *              has the columns timestamp,final_value; both are newest first.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <ArduinoJson.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <time.h>
+
+#include "Dataset.h"
+
+// "2026-01-11T21:14:47.301647+00:00" or "2026-01-11 21:14:47.301647+00:00", always UTC
+static uint32_t parseTimestamp(const char* text) {
+    struct tm time = {};
+    if (sscanf(text, "%d-%d-%d%*c%d:%d:%d", &time.tm_year, &time.tm_mon, &time.tm_mday,
+               &time.tm_hour, &time.tm_min, &time.tm_sec) != 6) return 0;
+    time.tm_year -= 1900;
+    time.tm_mon -= 1;
+    return (uint32_t)timegm(&time);
+}
+
+static bool endsWith(const std::string& text, const char* suffix) {
+    size_t length = strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+bool loadDataset(const char* path, std::vector<Sample>& samples) {
+    std::ifstream file(path);
+    if (!file) return false;
+    std::stringstream content;
+    content << file.rdbuf();
+    std::string text = content.str();
+
+    samples.clear();
+    if (endsWith(path, ".json")) {
+        JsonDocument doc;
+        if (deserializeJson(doc, text.c_str(), text.size())) return false;
+        for (JsonVariant reading : doc.as<JsonArray>()) {
+            samples.push_back({0, parseTimestamp(reading["created_at"] | ""), reading["final_value"] | 0.0f});
+        }
+    } else {
+        std::istringstream lines(text);
+        std::string line;
+        std::getline(lines, line); // Header
+        while (std::getline(lines, line)) {
+            size_t comma = line.find(',');
+            if (comma == std::string::npos) continue;
+            samples.push_back({0, parseTimestamp(line.c_str()), strtof(line.c_str() + comma + 1, nullptr)});
+        }
+    }
+    if (samples.empty()) return false;
+
+    std::stable_sort(samples.begin(), samples.end(), [](const Sample& a, const Sample& b) { return a.epoch < b.epoch; });
+    for (Sample& sample : samples) {
+        sample.timestamp = (unsigned long)(sample.epoch - samples.front().epoch) * 1000UL;
+    }
+    return true;
+}
@@ -0,0 +1,21 @@
+/*
+ * File: Dataset.h
+ * Description: Loads the exported readings in misc/statistics/ (*.json or *.csv) as samples for the host tools.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef NATIVE_DATASET_H
+#define NATIVE_DATASET_H
+
+#include <vector>
+
+#include "ecomonitor/Sampler.h"
+
+// Samples oldest first, with epoch set from the export's timestamp and timestamp in millis since the first one.
+// False if the file cannot be read or holds no readings.
+bool loadDataset(const char* path, std::vector<Sample>& samples);
+
+#endif
@@ -0,0 +1,486 @@
+/*
+ * File: NativeHal.cpp
+ * Description: Fake HAL backends for the Linux host build, plus a global allocation tracker
+ *              that stands in for the ESP32 heap statistics.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <algorithm>
+#include <malloc.h>
+
+#include "NativeHal.h"
+#include "ecomonitor/EcoMonitor.h"
+
+static NativeHal::AllocationStats allocationStats = {0, 0, 0, 0, 0};
+static long long heapBaseline = 0;
+
+// glibc's own entry points; everything else (operator new, strdup, ArduinoJson's default allocator, ...)
+// ends up in the replacements below, so every heap allocation of the program is counted
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void __libc_free(void* ptr);
+}
+
+static void trackAllocation(void* ptr) {
+    if (!ptr) return;
+    allocationStats.allocations++;
+    allocationStats.bytesAllocated += malloc_usable_size(ptr);
+    allocationStats.bytesInUse += malloc_usable_size(ptr);
+    if (allocationStats.bytesInUse > allocationStats.peakBytesInUse) {
+        allocationStats.peakBytesInUse = allocationStats.bytesInUse;
+    }
+}
+
+static void trackFree(void* ptr) {
+    if (!ptr) return;
+    allocationStats.frees++;
+    allocationStats.bytesInUse -= malloc_usable_size(ptr);
+}
+
+extern "C" void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    trackAllocation(ptr);
+    return ptr;
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    trackAllocation(ptr);
+    return ptr;
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    trackFree(ptr);
+    void* moved = __libc_realloc(ptr, size);
+    trackAllocation(moved);
+    return moved;
+}
+
+extern "C" void free(void* ptr) {
+    trackFree(ptr);
+    __libc_free(ptr);
+}
+
+int FakeAdc::read(uint8_t pin) {
+    (void)pin;
+    reads++;
+    if (noise == 0) return value;
+    seed = seed * 1664525UL + 1013904223UL;
+    int raw = value + (int)(seed >> 16) % (2 * noise + 1) - noise;
+    return raw < 0 ? 0 : (raw > 4095 ? 4095 : raw);
+}
+
+void FakeDisplay::setPixel(int16_t x, int16_t y) {
+    if (x < 0 || x >= 128 || y < 0 || y >= 64) return;
+    buffer[(y / 8) * 128 + x] |= 1 << (y % 8);
+}
+
+void FakeDisplay::print(const char* text) {
+    for (; *text; text++) {
+        uint8_t c = (uint8_t)*text;
+        for (int column = 0; column < 5; column++) {
+            uint8_t bits = c == ' ' ? 0 : (uint8_t)((c * 37 + column * 11) ^ (c >> 2)) & 0x7F;
+            for (int row = 0; row < 7; row++) {
+                if (!(bits & (1 << row))) continue;
+                for (int dx = 0; dx < textSize; dx++) {
+                    for (int dy = 0; dy < textSize; dy++) {
+                        setPixel(cursorX + column * textSize + dx, cursorY + row * textSize + dy);
+                    }
+                }
+            }
+        }
+        cursorX += 6 * textSize;
+    }
+}
+
+void FakeDisplay::print(float value, int digits) {
+    char text[24];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    print(text);
+}
+
+void FakeDisplay::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    int dx = abs(x1 - x0), dy = -abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+    int error = dx + dy;
+    while (true) {
+        setPixel(x0, y0);
+        if (x0 == x1 && y0 == y1) break;
+        int twice = 2 * error;
+        if (twice >= dy) { error += dy; x0 += sx; }
+        if (twice <= dx) { error += dx; y0 += sy; }
+    }
+}
+
+// Same framing as Esp32Display::sendRegions: one addressing transaction per region, data in 127 byte chunks
+size_t FakeDisplay::sendRegions(const DisplayRegion* regions, size_t count) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t length = regions[i].lastColumn - regions[i].firstColumn + 1;
+        bytes += 8 + length + 2 * ((length + 126) / 127);
+    }
+    frames++;
+    bytesSent += bytes;
+    NativeHal::clock().advanceMicros((uint64_t)bytes * 9 * 1000000ULL / OLED_I2C_CLOCK);
+    return bytes;
+}
+
+const std::string* FakeStorage::lookup(const char* key) {
+    reads++;
+    NativeHal::clock().advanceMicros(readMicros);
+    auto it = values.find(key);
+    return it == values.end() ? nullptr : &it->second;
+}
+
+bool FakeStorage::getBool(const char* key, bool defaultValue) {
+    const std::string* value = lookup(key);
+    return value ? *value == "1" : defaultValue;
+}
+
+String FakeStorage::getString(const char* key, const String& defaultValue) {
+    const std::string* value = lookup(key);
+    return value ? String(*value) : defaultValue;
+}
+
+uint32_t FakeStorage::getUInt(const char* key, uint32_t defaultValue) {
+    const std::string* value = lookup(key);
+    return value ? (uint32_t)strtoul(value->c_str(), nullptr, 10) : defaultValue;
+}
+
+float FakeStorage::getFloat(const char* key, float defaultValue) {
+    const std::string* value = lookup(key);
+    return value ? strtof(value->c_str(), nullptr) : defaultValue;
+}
+
+size_t FakeStorage::getBytes(const char* key, void* buffer, size_t length) {
+    const std::string* value = lookup(key);
+    if (!value) return 0;
+    size_t n = std::min(length, value->size());
+    memcpy(buffer, value->data(), n);
+    return n;
+}
+
+void FakeStorage::putBytes(const char* key, const void* value, size_t length) {
+    values[key] = std::string((const char*)value, length);
+    writes++;
+}
+
+bool FakeBlockStore::read(size_t offset, void* out, size_t length) {
+    if (offset + length > data.size()) return false;
+    memcpy(out, data.data() + offset, length);
+    return true;
+}
+
+bool FakeBlockStore::write(size_t offset, const void* in, size_t length) {
+    if (offset + length > data.size()) return false;
+    const uint8_t* bytes = (const uint8_t*)in;
+    for (size_t i = 0; i < length; i++) {
+        if (data[offset + i] != 0xFF) unerasedWrites++;
+        data[offset + i] &= bytes[i];
+    }
+    bytesWritten += length;
+    return true;
+}
+
+bool FakeBlockStore::erase(size_t offset, size_t length) {
+    if (offset % sectorSize() != 0 || length % sectorSize() != 0 || offset + length > data.size()) return false;
+    std::fill(data.begin() + offset, data.begin() + offset + length, 0xFF);
+    sectorErases += length / sectorSize();
+    return true;
+}
+
+int FakeHttp::post(const char* url, const char* contentType, const uint8_t* body, size_t length, HttpResponse& response) {
+    (void)contentType;
+    response.length = 0;
+    response.body[0] = '\0';
+    response.contentType[0] = '\0';
+
+    FakeClock& clock = NativeHal::clock();
+    if (open && clock.millis() - lastActivity > keepAliveTimeoutMs) {
+        open = false; // Closed by the server while idle
+        return HTTP_ERROR_SEND_FAILED;
+    }
+    if (!open) {
+        handshakes++;
+        clock.delay(handshakeMs);
+        open = true;
+    }
+
+    requests++;
+    lastUrl = url;
+    lastPayload.assign((const char*)body, length);
+    bytesSent += length;
+    clock.delay(latencyMs);
+    lastActivity = clock.millis();
+    if (responseCode > 0) {
+        std::string body = responseBody;
+        if (!queuedBodies.empty() && responseCode < 300) {
+            body = queuedBodies.front();
+            queuedBodies.pop_front();
+        }
+        bytesReceived += body.size();
+        response.length = body.copy(response.body, response.capacity - 1);
+        response.body[response.length] = '\0';
+        strlcpy(response.contentType, "application/json", sizeof(response.contentType));
+    }
+    return responseCode;
+}
+
+const char* FakeHttp::errorToString(int code) {
+    switch (code) {
+        case HTTP_ERROR_CONNECTION_REFUSED: return "connection refused";
+        case HTTP_ERROR_SEND_FAILED: return "send failed";
+        case HTTP_ERROR_READ_TIMEOUT: return "read Timeout";
+        default: return "unknown error";
+    }
+}
+
+bool FakeMqtt::connect(const char* host, uint16_t port, const char* clientId, const char* willTopic,
+                       const char* willMessage) {
+    (void)host; (void)port; (void)clientId;
+    connects++;
+    NativeHal::clock().delay(connectMs);
+    open = brokerUp && NativeHal::network().isConnected();
+    if (open) {
+        this->willTopic = willTopic;
+        this->willMessage = willMessage;
+    }
+    return open;
+}
+
+bool FakeMqtt::connected() {
+    if (open && (!brokerUp || !NativeHal::network().isConnected())) {
+        open = false;
+        if (!willTopic.empty()) retainedMessages[willTopic] = willMessage;
+    }
+    return open;
+}
+
+bool FakeMqtt::subscribe(const char* topic) {
+    if (!connected()) return false;
+    subscriptions.insert(topic);
+    return true;
+}
+
+bool FakeMqtt::publish(const char* topic, const uint8_t* payload, size_t length, bool retained) {
+    if (!connected()) return false;
+    published++;
+    bytesPublished += length;
+    lastTopic = topic;
+    lastPayload.assign((const char*)payload, length);
+    if (retained) retainedMessages[topic] = lastPayload;
+    return true;
+}
+
+bool FakeMqtt::loop() {
+    if (!connected()) return false;
+    if (!queue.empty() && subscriptions.count(queue.front().topic)) {
+        const Message& message = queue.front();
+        delivered++;
+        if (handler && !handler(message.topic.c_str(), (const uint8_t*)message.payload.data(), message.payload.size())) {
+            open = false;   // Not acknowledged, it stays first in the session
+            return true;
+        }
+        queue.pop_front();
+    }
+    return true;
+}
+
+void FakeMqtt::inject(const std::string& topic, const std::string& payload) {
+    queue.push_back({topic, payload});
+}
+
+void FakeNetwork::startStation(const char* ssid, const char* password, const StationHint* hint) {
+    (void)ssid; (void)password;
+    bool hinted = hint && hint->channel;
+    station = true;
+    connected = false;
+    connecting = true;
+    connectAt = NativeHal::clock().millis() + (hinted ? hintedMs : scanMs) + (hinted && hint->ip ? 0 : dhcpMs);
+    connects++;
+    if (hinted) hintedConnects++;
+}
+
+bool FakeNetwork::stationHint(StationHint& hint) {
+    if (!isConnected()) return false;
+    static const uint8_t bssid[6] = {0x24, 0x0A, 0xC4, 0x5E, 0x10, 0x01};
+    memcpy(hint.bssid, bssid, sizeof(bssid));
+    hint.channel = 6;
+    hint.ip = 0x3201A8C0;       // 192.168.1.50
+    hint.gateway = 0x0101A8C0;
+    hint.subnet = 0x00FFFFFF;
+    hint.dns = 0x0101A8C0;
+    return true;
+}
+
+void FakeNetwork::update() {
+    if (connected && !linkUp) {
+        connected = false;
+    } else if (connecting && NativeHal::clock().millis() >= connectAt) {
+        connecting = false;
+        connected = linkUp;     // An attempt while the link is down fails silently, the firmware times it out
+    }
+}
+
+void FakeNetwork::runEvents() {
+    update();
+    bool up = station && connected;
+    if (up != reportedConnected && handler) {
+        handler(up ? STATION_CONNECTED : STATION_DISCONNECTED);
+    }
+    reportedConnected = up;
+}
+
+void FakeNetwork::startAccessPoint(const char* ssid, const char* password) {
+    (void)ssid; (void)password;
+    station = false;
+    connected = false;
+    connecting = false;
+}
+
+String FakeWebRequest::arg(const char* name) {
+    auto it = args.find(name);
+    return it == args.end() ? String() : String(it->second);
+}
+
+void FakeWebRequest::send(int code, const char* contentType, const char* content) {
+    this->code = code;
+    this->contentType = contentType;
+    body = content;
+}
+
+void FakeWebRequest::sendGzip(int code, const char* contentType, const uint8_t* data, size_t length) {
+    this->code = code;
+    this->contentType = contentType;
+    body.assign((const char*)data, length);
+    gzipped = true;
+}
+
+int FakeWebServer::request(bool post, const char* uri, const std::map<std::string, std::string>& requestArgs) {
+    std::map<std::string, Handler>& routes = post ? postRoutes : getRoutes;
+    auto it = routes.find(uri);
+    if (it == routes.end()) return 404;
+    FakeWebRequest request(requestArgs);
+    it->second(request);
+    requests++;
+    bytesServed += request.body.size();
+    lastCode = request.code;
+    lastContentType = request.contentType;
+    lastBody = request.body;
+    return lastCode;
+}
+
+size_t FakeWebServer::streamQueued(uint32_t client) {
+    auto it = subscribers.find(client);
+    return it == subscribers.end() ? 0 : it->second.queued;
+}
+
+void FakeWebServer::streamSend(uint32_t client, const char* text, size_t length) {
+    (void)text;
+    auto it = subscribers.find(client);
+    if (it == subscribers.end() || !it->second.open) return;
+    it->second.queued++;
+    streamBytes += length;
+}
+
+// The server reports the disconnect like any other, the library does that from its own task
+void FakeWebServer::streamClose(uint32_t client) {
+    auto it = subscribers.find(client);
+    if (it == subscribers.end() || !it->second.open) return;
+    it->second.open = false;
+    it->second.queued = 0;
+    if (streamHandler) streamHandler(client, false);
+}
+
+uint32_t FakeWebServer::connectSubscriber(bool slow) {
+    uint32_t client = nextClient++;
+    subscribers[client] = {slow, true, 0, 0};
+    if (streamHandler) streamHandler(client, true);
+    return client;
+}
+
+void FakeWebServer::drainStreams() {
+    for (auto& entry : subscribers) {
+        Subscriber& subscriber = entry.second;
+        if (!subscriber.open || subscriber.slow) continue;
+        subscriber.received += subscriber.queued;
+        subscriber.queued = 0;
+    }
+}
+
+void FakeTempProbe::requestTemperatures() {
+    conversions++;
+    if (waitForConversion) {
+        unsigned long conversionTime = 750UL >> (12 - resolution);
+        blockedMillis += conversionTime;
+        NativeHal::clock().delay(conversionTime);
+    }
+}
+
+bool FakeSystem::startTask(const char* name, void (*step)(), unsigned long periodMs, uint32_t stackSize, int core) {
+    (void)stackSize; (void)core;
+    tasks[name] = Task{step, periodMs, NativeHal::clock().millis()};
+    return true;
+}
+
+void FakeSystem::runTasks() {
+    unsigned long now = NativeHal::clock().millis();
+    for (auto& entry : tasks) {
+        Task& task = entry.second;
+        if (now - task.lastRun >= task.periodMs) {
+            task.lastRun = now;
+            task.step();
+        }
+    }
+}
+
+uint32_t FakeSystem::freeHeap() {
+    long long inUse = allocationStats.bytesInUse - heapBaseline;
+    if (inUse < 0) inUse = 0;
+    return inUse >= NativeHal::HEAP_SIZE ? 0 : NativeHal::HEAP_SIZE - (uint32_t)inUse;
+}
+
+uint32_t FakeSystem::minFreeHeap() {
+    long long peak = allocationStats.peakBytesInUse - heapBaseline;
+    return peak >= NativeHal::HEAP_SIZE ? 0 : NativeHal::HEAP_SIZE - (uint32_t)peak;
+}
+
+namespace NativeHal {
+    AllocationStats allocations() { return allocationStats; }
+
+    void setHeapBaseline() {
+        heapBaseline = allocationStats.bytesInUse;
+        allocationStats.peakBytesInUse = heapBaseline;
+    }
+
+    FakeClock& clock() { static FakeClock instance; return instance; }
+    FakeAdc& adc() { static FakeAdc instance; return instance; }
+    FakeDisplay& display() { static FakeDisplay instance; return instance; }
+    FakeStorage& storage() { static FakeStorage instance; return instance; }
+    FakeBlockStore& blockStore() { static FakeBlockStore instance; return instance; }
+    FakeHttp& http() { static FakeHttp instance; return instance; }
+    FakeMqtt& mqtt() { static FakeMqtt instance; return instance; }
+    FakeNetwork& network() { static FakeNetwork instance; return instance; }
+    FakeWebServer& webServer() { static FakeWebServer instance; return instance; }
+    FakeSystem& system() { static FakeSystem instance; return instance; }
+    FakeTempProbe& tempProbe() { static FakeTempProbe instance; return instance; }
+    FakeHumidityProbe& humidityProbe() { static FakeHumidityProbe instance; return instance; }
+}
+
+namespace Hal {
+    ClockInterface& clock() { return NativeHal::clock(); }
+    AdcInterface& adc() { return NativeHal::adc(); }
+    DisplayInterface& display() { return NativeHal::display(); }
+    StorageInterface& storage() { return NativeHal::storage(); }
+    BlockStoreInterface& blockStore() { return NativeHal::blockStore(); }
+    HttpInterface& http() { return NativeHal::http(); }
+    MqttInterface& mqtt() { return NativeHal::mqtt(); }
+    NetworkInterface& network() { return NativeHal::network(); }
+    WebServerInterface& webServer() { return NativeHal::webServer(); }
+    SystemInterface& system() { return NativeHal::system(); }
+    TempProbeInterface& tempProbe() { return NativeHal::tempProbe(); }
+    HumidityProbeInterface& humidityProbe() { return NativeHal::humidityProbe(); }
+}
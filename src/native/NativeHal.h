@@ -0,0 +1,390 @@
+/*
+ * File: NativeHal.h
+ * Description: Fake HAL backends for the Linux host build. They behave like a healthy device by default
+ *              (Wi-Fi up, server answers 201) and expose knobs and counters for the host runner.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ecomonitor/hal/Hal.h"
+
+// Virtual time: delay() advances the clock instantly, so a 15-minute upload interval replays in milliseconds
+class FakeClock : public ClockInterface {
+public:
+    unsigned long millis() override { return (unsigned long)(nowMicros / 1000ULL); }
+    unsigned long micros() override { return (unsigned long)nowMicros; }
+    void delay(unsigned long ms) override { nowMicros += (uint64_t)ms * 1000ULL; }
+    void startTimeSync() override { synced = true; }
+    uint32_t epoch() override { return synced ? START_EPOCH + (uint32_t)(nowMicros / 1000000ULL) : 0; }
+    void advanceMicros(uint64_t us) { nowMicros += us; }
+
+    static const uint32_t START_EPOCH = 1768150000; // Start of the misc/statistics traces
+
+private:
+    uint64_t nowMicros = 0;
+    bool synced = false;
+};
+
+// Returns a fixed level plus optional uniform noise, like a floating ESP32 ADC input
+class FakeAdc : public AdcInterface {
+public:
+    int read(uint8_t pin) override;
+    uint32_t readMilliVolts(uint8_t pin) override { return (uint32_t)read(pin) * 3300UL / 4095UL; }
+    void setValue(int raw) { value = raw; }
+    void setNoise(int amplitude) { noise = amplitude; }
+
+    unsigned long reads = 0;
+
+private:
+    int value = 1200;
+    int noise = 0;
+    uint32_t seed = 1;
+};
+
+// Draws into an SSD1306-layout framebuffer with a made-up 5x7 font (every character gets its own distinct
+// pattern), so the renderer's page/column diff sees realistic changes. Sending charges the bus time at
+// OLED_I2C_CLOCK, 9 bit times per byte, to the virtual clock.
+class FakeDisplay : public DisplayInterface {
+public:
+    bool begin() override { return true; }
+    void clear() override { memset(buffer, 0, sizeof(buffer)); cursorX = cursorY = 0; }
+    void setTextSize(uint8_t size) override { textSize = size; }
+    void setCursor(int16_t x, int16_t y) override { cursorX = x; cursorY = y; }
+    void print(const char* text) override;
+    void print(float value, int digits) override;
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1) override;
+    const uint8_t* framebuffer() override { return buffer; }
+    size_t sendRegions(const DisplayRegion* regions, size_t count) override;
+    void setPower(bool on) override { powered = on; }
+
+    unsigned long frames = 0;
+    unsigned long bytesSent = 0;
+    bool powered = true;
+
+private:
+    void setPixel(int16_t x, int16_t y);
+
+    uint8_t buffer[128 * 64 / 8] = {};
+    int16_t cursorX = 0;
+    int16_t cursorY = 0;
+    uint8_t textSize = 1;
+};
+
+// Every lookup costs readMicros of virtual time, about what an NVS read through Preferences takes on the ESP32
+class FakeStorage : public StorageInterface {
+public:
+    bool begin(const char* name) override { (void)name; return true; }
+    bool getBool(const char* key, bool defaultValue) override;
+    void putBool(const char* key, bool value) override { values[key] = value ? "1" : "0"; writes++; }
+    String getString(const char* key, const String& defaultValue) override;
+    void putString(const char* key, const String& value) override { values[key] = value.c_str(); writes++; }
+    uint32_t getUInt(const char* key, uint32_t defaultValue) override;
+    void putUInt(const char* key, uint32_t value) override { values[key] = std::to_string(value); writes++; }
+    float getFloat(const char* key, float defaultValue) override;
+    void putFloat(const char* key, float value) override { values[key] = std::to_string(value); writes++; }
+    size_t getBytes(const char* key, void* buffer, size_t length) override;
+    void putBytes(const char* key, const void* value, size_t length) override;
+    void remove(const char* key) override { if (values.erase(key)) writes++; }
+    void clear() override { values.clear(); writes++; }
+
+    unsigned long readMicros = 20;
+    unsigned long reads = 0;
+    unsigned long writes = 0;
+
+private:
+    const std::string* lookup(const char* key);  // nullptr if the key is missing
+
+    std::map<std::string, std::string> values;
+};
+
+// In-memory flash region; it outlives a simulated restart like the real file does
+class FakeBlockStore : public BlockStoreInterface {
+public:
+    bool begin(size_t size) override { if (data.size() != size) data.assign(size, 0xFF); return true; }
+    bool read(size_t offset, void* out, size_t length) override;
+    bool write(size_t offset, const void* in, size_t length) override;  // Clears bits only, like the flash
+    bool erase(size_t offset, size_t length) override;
+    size_t sectorSize() override { return 4096; }
+    void eraseAll() { data.assign(data.size(), 0xFF); }   // A freshly erased partition
+
+    unsigned long bytesWritten = 0;
+    unsigned long sectorErases = 0;
+    unsigned long unerasedWrites = 0;   // Bytes written over a byte that was not erased
+
+private:
+    std::vector<uint8_t> data;
+};
+
+// Scripted API server: every POST gets the same response after a fixed latency. A new connection also pays
+// the handshake time; the server closes connections that stay idle longer than its keep-alive timeout,
+// and like a real socket, the client only notices when the next request fails.
+class FakeHttp : public HttpInterface {
+public:
+    int post(const char* url, const char* contentType, const uint8_t* body, size_t length, HttpResponse& response) override;
+    void setTimeout(uint16_t timeout) override { (void)timeout; }
+    const char* errorToString(int code) override;
+    bool connected() override { return open; }
+    void disconnect() override { open = false; }
+
+    void setResponse(int code, const char* body) { responseCode = code; responseBody = body; }
+    void queueResponse(const std::string& body) { queuedBodies.push_back(body); }  // Answers the next 2xx POST
+    void setLatency(unsigned long ms) { latencyMs = ms; }
+    void setHandshake(unsigned long ms) { handshakeMs = ms; }
+    void setKeepAliveTimeout(unsigned long ms) { keepAliveTimeoutMs = ms; }
+
+    unsigned long requests = 0;
+    unsigned long handshakes = 0;
+    unsigned long bytesSent = 0;
+    unsigned long bytesReceived = 0;
+    std::string lastUrl;
+    std::string lastPayload;
+
+private:
+    int responseCode = 201;
+    std::string responseBody = "{}";
+    std::deque<std::string> queuedBodies;
+    unsigned long latencyMs = 0;
+    unsigned long handshakeMs = 0;
+    unsigned long keepAliveTimeoutMs = 60000;
+    unsigned long lastActivity = 0;
+    bool open = false;
+};
+
+// Stand-in for a Mosquitto broker with the firmware as its only client. The runner publishes to the device's topics
+// with inject(); messages to a subscribed topic wait in the persistent session, also while the client is offline,
+// until loop() takes them, one per call like PubSubClient. Connecting costs connectMs; the connection is lost
+// with the Wi-Fi link, and then the broker publishes the client's will.
+class FakeMqtt : public MqttInterface {
+public:
+    bool connect(const char* host, uint16_t port, const char* clientId, const char* willTopic,
+                 const char* willMessage) override;
+    bool connected() override;
+    void disconnect() override { open = false; }
+    bool subscribe(const char* topic) override;
+    bool publish(const char* topic, const uint8_t* payload, size_t length, bool retained) override;
+    void onMessage(MessageHandler handler) override { this->handler = handler; }
+    bool loop() override;
+
+    void setBrokerUp(bool up) { brokerUp = up; }
+    void inject(const std::string& topic, const std::string& payload);
+    size_t pending() const { return queue.size(); }
+
+    unsigned long connectMs = 150;
+    unsigned long connects = 0;
+    unsigned long published = 0;
+    unsigned long bytesPublished = 0;
+    unsigned long delivered = 0;
+    std::map<std::string, std::string> retainedMessages;
+    std::string lastTopic;
+    std::string lastPayload;
+
+private:
+    struct Message {
+        std::string topic;
+        std::string payload;
+    };
+
+    bool open = false;
+    bool brokerUp = true;
+    std::set<std::string> subscriptions;   // Kept across connections, the session is persistent
+    std::deque<Message> queue;
+    std::string willTopic;
+    std::string willMessage;
+    MessageHandler handler = nullptr;
+};
+
+// A connect takes virtual time: a full channel scan, or much less with a BSSID/channel hint, plus DHCP unless the
+// hint carries an address. The connection drops when the link goes down and stays down until the firmware
+// starts the station again; events reach the firmware when the runner calls runEvents().
+class FakeNetwork : public NetworkInterface {
+public:
+    void startStation(const char* ssid, const char* password, const StationHint* hint) override;
+    bool stationHint(StationHint& hint) override;
+    void onStationEvent(StationHandler handler) override { this->handler = handler; }
+    void startAccessPoint(const char* ssid, const char* password) override;
+    bool isConnected() override { update(); return station && connected; }
+    bool isStation() override { return station; }
+    bool isAccessPoint() override { return !station; }
+    String localIP() override { return String("192.168.1.50"); }
+    String softAPIP() override { return String("192.168.4.1"); }
+
+    void setLinkUp(bool up) { linkUp = up; }
+    void powerOff() { station = false; connected = false; connecting = false; reportedConnected = false; } // After deep sleep
+    void runEvents();
+
+    unsigned long scanMs = 2500;    // Connect without a hint
+    unsigned long hintedMs = 300;   // Connect straight to the hinted BSSID and channel
+    unsigned long dhcpMs = 700;
+    unsigned long connects = 0;
+    unsigned long hintedConnects = 0;
+
+private:
+    void update();
+
+    bool station = false;
+    bool linkUp = true;
+    bool connecting = false;
+    bool connected = false;
+    bool reportedConnected = false; // Last state the firmware was told about
+    unsigned long connectAt = 0;
+    StationHandler handler = nullptr;
+};
+
+class FakeWebRequest : public WebRequest {
+public:
+    explicit FakeWebRequest(const std::map<std::string, std::string>& args) : args(args) {}
+    bool hasArg(const char* name) override { return args.count(name) > 0; }
+    String arg(const char* name) override;
+    void send(int code, const char* contentType, const char* content) override;
+    void sendGzip(int code, const char* contentType, const uint8_t* data, size_t length) override;
+
+    int code = 0;
+    std::string contentType;
+    std::string body;
+    bool gzipped = false;
+
+private:
+    const std::map<std::string, std::string>& args;
+};
+
+// Handlers run when the runner calls request(), outside the timed loop pass, like on the async_tcp task
+class FakeWebServer : public WebServerInterface {
+public:
+    void onGet(const char* uri, Handler handler) override { getRoutes[uri] = handler; }
+    void onPost(const char* uri, Handler handler) override { postRoutes[uri] = handler; }
+    void begin() override { started = true; }
+    void openStream(const char* uri, StreamHandler handler) override { (void)uri; streamHandler = handler; }
+    size_t streamQueued(uint32_t client) override;
+    void streamSend(uint32_t client, const char* text, size_t length) override;
+    void streamClose(uint32_t client) override;
+
+    // Runs a registered handler as if a client had requested it; returns the status code sent
+    int request(bool post, const char* uri, const std::map<std::string, std::string>& requestArgs = {});
+
+    // Stream subscribers: drainStreams() delivers everything queued to the others, a slow one never reads
+    struct Subscriber {
+        bool slow;
+        bool open;
+        size_t queued;
+        unsigned long received;
+    };
+    uint32_t connectSubscriber(bool slow);
+    void drainStreams();
+    std::map<uint32_t, Subscriber> subscribers;
+    unsigned long streamBytes = 0;
+
+    bool started = false;
+    unsigned long requests = 0;
+    unsigned long bytesServed = 0;
+    int lastCode = 0;
+    std::string lastContentType;
+    std::string lastBody;
+
+private:
+    std::map<std::string, Handler> getRoutes;
+    std::map<std::string, Handler> postRoutes;
+    StreamHandler streamHandler = nullptr;
+    uint32_t nextClient = 1;
+};
+
+// Tasks do not get a thread on the host: the runner calls runTasks() after every loop() pass,
+// which keeps virtual time deterministic and lets it time the task separately from the loop.
+class FakeSystem : public SystemInterface {
+public:
+    bool startTask(const char* name, void (*step)(), unsigned long periodMs, uint32_t stackSize, int core) override;
+    void restart() override { restartRequested = true; }
+    uint64_t efuseMac() override { return 0x94085A0A5ULL; }
+    uint32_t freeHeap() override;
+    uint32_t minFreeHeap() override;
+    uint32_t largestFreeBlock() override { return freeHeap(); } // The host heap does not fragment like the ESP32's
+    uint32_t stackHighWater(const char* task) override { (void)task; return 0; } // Tasks share the host thread's stack
+    void deepSleep(uint64_t micros) override { sleepRequested = true; sleepMicros = micros; }
+    bool wokeFromSleep() override { return timerWake; }
+    void runTasks();
+
+    bool restartRequested = false;
+    bool sleepRequested = false;    // The runner advances the clock by sleepMicros and boots again with timerWake set
+    uint64_t sleepMicros = 0;
+    bool timerWake = false;
+
+private:
+    struct Task {
+        void (*step)();
+        unsigned long periodMs;
+        unsigned long lastRun;
+    };
+    std::map<std::string, Task> tasks;
+};
+
+// A blocking conversion stalls the fake clock for as long as the real probe would
+class FakeTempProbe : public TempProbeInterface {
+public:
+    void begin() override {}
+    void setResolution(uint8_t bits) override { resolution = bits; }
+    void setWaitForConversion(bool wait) override { waitForConversion = wait; }
+    void requestTemperatures() override;
+    float getTempC() override { return value; }
+
+    float value = 24.625f;
+    uint8_t resolution = 12;
+    bool waitForConversion = true;
+    unsigned long conversions = 0;
+    unsigned long blockedMillis = 0;
+};
+
+class FakeHumidityProbe : public HumidityProbeInterface {
+public:
+    void begin() override {}
+    bool read(float& temperature, float& humidity) override {
+        transactions++;
+        temperature = this->temperature;
+        humidity = value;
+        return true;
+    }
+
+    float value = 53.3f;
+    float temperature = 21.4f;
+    unsigned long transactions = 0;
+};
+
+namespace NativeHal {
+    // Simulated ESP32 heap size, used to turn the host allocation tracker into a free-heap figure
+    const uint32_t HEAP_SIZE = 320 * 1024;
+
+    struct AllocationStats {
+        unsigned long allocations;
+        unsigned long frees;
+        unsigned long long bytesAllocated;
+        long long bytesInUse;
+        long long peakBytesInUse;
+    };
+
+    AllocationStats allocations();
+    void setHeapBaseline();   // Memory in use now belongs to the runner and is left out of the heap figures
+
+    FakeClock& clock();
+    FakeAdc& adc();
+    FakeDisplay& display();
+    FakeStorage& storage();
+    FakeBlockStore& blockStore();
+    FakeHttp& http();
+    FakeMqtt& mqtt();
+    FakeNetwork& network();
+    FakeWebServer& webServer();
+    FakeSystem& system();
+    FakeTempProbe& tempProbe();
+    FakeHumidityProbe& humidityProbe();
+}
+
+#endif
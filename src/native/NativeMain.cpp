@@ -0,0 +1,396 @@
+/*
+ * File: NativeMain.cpp
+ * Description: Entry point of the [env:native] build. Boots the firmware against the fake HAL, runs loop()
+ *              in virtual time and reports loop latency, heap use and upload throughput.
+ *              Usage: program [--iterations N] [--reading-time MINUTES] [--http-latency MS] [--handshake MS] [--batch SIZE]
+ *                             [--outage FROM_S:TO_S] [--reboot-at S] [--encoding json|msgpack] [--deep-sleep]
+ *                             [--alarm LEVEL] [--alarm-rise UNITS_PER_MIN] [--spike S] [--adc-noise LSB]
+ *                             [--portal-poll S] [--subscribers N] [--slow-subscribers N] [--mqtt] [--commands S:N]
+ *                             [--metrics] [--verbose]
+ *                     With --deep-sleep every wake counts as one iteration. --portal-poll requests the local
+ *                     HTTP API every S virtual seconds between two passes, as a browser on the LAN would.
+ *                     --subscribers connects live-stream clients that read everything between two passes,
+ *                     --slow-subscribers ones that never read. --metrics prints what GET /metrics returns at the end.
+ *                     --spike makes the sensor read far above any alarm level from virtual second S on.
+ *                     --mqtt configures a broker (the fake one in NativeHal). --commands sends N commands at virtual
+ *                     second S: published on the command topic with --mqtt, else one per upload response.
+ *                     program --codec FILE... (round trip and size of the upload encodings, see CodecReport.cpp)
+ *                     program --replay FILE... [--heartbeat MINUTES] (upload policies on exported data, see PolicyReplay.cpp)
+ *                     program --stream-bench (live-stream fan-out cost per subscriber, see StreamBench.cpp)
+ *                     program --bench FILE... [--days N] [--baseline FILE] [--write-baseline FILE] [--tolerance PCT]
+ *                             [--throughput-tolerance PCT] (reading pipeline on exported data, see PipelineBench.cpp)
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "CodecReport.h"
+#include "NativeHal.h"
+#include "PipelineBench.h"
+#include "PolicyReplay.h"
+#include "StreamBench.h"
+#include "ecomonitor/Config.h"
+#include "ecomonitor/DutyCycle.h"
+#include "ecomonitor/EcoMonitor.h"
+#include "ecomonitor/LiveStream.h"
+#include "ecomonitor/MqttChannel.h"
+#include "ecomonitor/Payload.h"
+#include "ecomonitor/Profiler.h"
+#include "ecomonitor/Scheduler.h"
+#include "ecomonitor/Screen.h"
+
+// The test programs in test/ are linked against the firmware with their own main()
+#ifndef PIO_UNIT_TESTING
+
+void setup();
+void loop();
+
+extern char device_id[];
+
+struct RunnerOptions {
+    unsigned long iterations = 40000;  // A pass per LOOP_UPLOAD_PERIOD, so about 33 minutes of device time
+    const char* readingTime = "1";
+    uint32_t batchSize = 1;
+    unsigned long httpLatencyMs = 0;
+    unsigned long handshakeMs = 0;
+    unsigned long outageFrom = 0, outageTo = 0; // Wi-Fi link down between these virtual seconds
+    unsigned long rebootAt = 0;
+    const char* encoding = "json";
+    bool deepSleep = false;
+    float alarmLevel = 0;
+    float alarmRise = 0;
+    unsigned long spikeAt = 0;
+    int adcNoise = 0;                   // Uniform noise on the raw ADC reading, so the displayed value changes
+    unsigned long portalPollSeconds = 0;
+    unsigned long subscribers = 0;
+    unsigned long slowSubscribers = 0;
+    bool mqtt = false;
+    unsigned long commandsAt = 0, commandCount = 0;
+    bool streamBench = false;
+    bool metrics = false;
+    std::vector<const char*> codecDatasets;
+    std::vector<const char*> replayDatasets;
+    unsigned long heartbeatMinutes = 120;
+    std::vector<const char*> benchDatasets;
+    PipelineBenchOptions bench;
+    bool verbose = false;
+};
+
+static bool parseOptions(int argc, char** argv, RunnerOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--iterations") && hasValue) options.iterations = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--reading-time") && hasValue) options.readingTime = argv[++i];
+        else if (!strcmp(argv[i], "--batch") && hasValue) options.batchSize = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--handshake") && hasValue) options.handshakeMs = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--http-latency") && hasValue) options.httpLatencyMs = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--outage") && hasValue) sscanf(argv[++i], "%lu:%lu", &options.outageFrom, &options.outageTo);
+        else if (!strcmp(argv[i], "--reboot-at") && hasValue) options.rebootAt = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--encoding") && hasValue) options.encoding = argv[++i];
+        else if (!strcmp(argv[i], "--deep-sleep")) options.deepSleep = true;
+        else if (!strcmp(argv[i], "--alarm") && hasValue) options.alarmLevel = strtof(argv[++i], nullptr);
+        else if (!strcmp(argv[i], "--alarm-rise") && hasValue) options.alarmRise = strtof(argv[++i], nullptr);
+        else if (!strcmp(argv[i], "--spike") && hasValue) options.spikeAt = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--adc-noise") && hasValue) options.adcNoise = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--portal-poll") && hasValue) options.portalPollSeconds = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--subscribers") && hasValue) options.subscribers = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--slow-subscribers") && hasValue) options.slowSubscribers = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--stream-bench")) options.streamBench = true;
+        else if (!strcmp(argv[i], "--mqtt")) options.mqtt = true;
+        else if (!strcmp(argv[i], "--commands") && hasValue) sscanf(argv[++i], "%lu:%lu", &options.commandsAt, &options.commandCount);
+        else if (!strcmp(argv[i], "--metrics")) options.metrics = true;
+        else if (!strcmp(argv[i], "--codec")) {
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) options.codecDatasets.push_back(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--replay")) {
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) options.replayDatasets.push_back(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--bench")) {
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) options.benchDatasets.push_back(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--days") && hasValue) options.bench.days = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--baseline") && hasValue) options.bench.baseline = argv[++i];
+        else if (!strcmp(argv[i], "--write-baseline") && hasValue) options.bench.writeBaseline = argv[++i];
+        else if (!strcmp(argv[i], "--tolerance") && hasValue) options.bench.tolerance = strtof(argv[++i], nullptr);
+        else if (!strcmp(argv[i], "--throughput-tolerance") && hasValue) {
+            options.bench.throughputTolerance = strtof(argv[++i], nullptr);
+        }
+        else if (!strcmp(argv[i], "--heartbeat") && hasValue) options.heartbeatMinutes = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--verbose")) options.verbose = true;
+        else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return false;
+        }
+    }
+    return options.iterations > 0;
+}
+
+int main(int argc, char** argv) {
+    RunnerOptions options;
+    if (!parseOptions(argc, argv, options)) return 2;
+    if (!options.codecDatasets.empty()) return runCodecReport(options.codecDatasets);
+    if (!options.replayDatasets.empty()) return runPolicyReplay(options.replayDatasets, options.heartbeatMinutes);
+    if (options.streamBench) return runStreamBench();
+    if (!options.benchDatasets.empty()) return runPipelineBench(options.benchDatasets, options.bench);
+
+    PayloadEncoding encoding;
+    if (!Payload::encodingFromName(options.encoding, encoding)) {
+        fprintf(stderr, "Unknown encoding: %s\n", options.encoding);
+        return 2;
+    }
+
+    // Pretend the user already went through the configuration portal: the blob setup() loads
+    FakeStorage& storage = NativeHal::storage();
+    Config::reset();
+    DeviceConfig& config = Config::edit();
+    config.configured = true;
+    strlcpy(config.ssid, "bench", sizeof(config.ssid));
+    strlcpy(config.password, "bench", sizeof(config.password));
+    config.readingMinutes = atoi(options.readingTime);
+    config.batchSize = options.batchSize;
+    config.encoding = encoding;
+    config.deepSleep = options.deepSleep;
+    config.alarmLevel = options.alarmLevel;
+    config.alarmRise = options.alarmRise;
+    if (options.mqtt) strlcpy(config.mqttBroker, "broker.local", sizeof(config.mqttBroker));
+    Config::flush();
+    NativeHal::adc().setNoise(options.adcNoise);
+    NativeHal::http().setLatency(options.httpLatencyMs);
+    NativeHal::http().setHandshake(options.handshakeMs);
+    Serial.setQuiet(!options.verbose);
+
+    std::vector<uint64_t> latencies;
+    latencies.reserve(options.iterations);
+    NativeHal::setHeapBaseline();
+
+    setup();
+
+    unsigned long restarts = 0;
+    unsigned long bootMillis = millis();
+    NativeHal::AllocationStats before = NativeHal::allocations();
+    unsigned long storageReadsBefore = storage.reads, storageWritesBefore = storage.writes;
+
+    bool rebooted = false;
+    unsigned long loopStallMax = 0, loopStallTotal = 0, taskBusyTotal = 0;
+    unsigned long sleepingSince = 0;
+    unsigned long lastPortalPoll = 0, portalErrors = 0, portalAllocations = 0;
+    bool subscribersConnected = false;
+    unsigned long spikeMillis = 0, spikeToServer = 0;
+    auto checkSpike = [&]() {
+        if (spikeMillis && !spikeToServer && Profiler::histogram(PROFILE_ALARM_UPLOAD).count > 0) {
+            spikeToServer = millis() - spikeMillis;
+        }
+    };
+    // Commands change the alarm hysteresis to 1..N, which does nothing else here; the last value seen after each
+    // pass has to grow if they run in order
+    unsigned long commandsSentAt = 0, commandsBefore = 0, commandsRun = 0, firstCommandMs = 0, lastCommandMs = 0;
+    float lastHysteresis = 0;
+    bool commandsInOrder = true;
+    auto checkCommands = [&]() {
+        unsigned long run = Profiler::histogram(PROFILE_COMMAND).count - commandsBefore;
+        if (!commandsSentAt || run == commandsRun) return;
+        if (commandsRun == 0) firstCommandMs = millis() - commandsSentAt;
+        commandsRun = run;
+        lastCommandMs = millis() - commandsSentAt;
+        commandsInOrder &= Config::get().alarmHysteresis >= lastHysteresis;
+        lastHysteresis = Config::get().alarmHysteresis;
+    };
+    for (unsigned long i = 0; i < options.iterations; i++) {
+        unsigned long seconds = millis() / 1000;
+        if (options.commandCount && seconds >= options.commandsAt && commandsSentAt == 0) {
+            commandsSentAt = millis();
+            commandsBefore = Profiler::histogram(PROFILE_COMMAND).count;
+            std::string topic = std::string(MQTT_TOPIC_PREFIX "/") + device_id + "/commands";
+            for (unsigned long k = 1; k <= options.commandCount; k++) {
+                char body[96];
+                snprintf(body, sizeof(body), "{\"command\":\"change_alarm_hysteresis\",\"payload\":\"%lu\"}", k);
+                if (options.mqtt) NativeHal::mqtt().inject(topic, body);
+                else NativeHal::http().queueResponse(body);
+            }
+        }
+        if (options.spikeAt && seconds >= options.spikeAt && spikeMillis == 0) {
+            // Every device type reads its own sensor, so all three are pushed up
+            spikeMillis = millis();
+            NativeHal::adc().setValue(3900);
+            NativeHal::tempProbe().value = 85.0f;
+            NativeHal::humidityProbe().value = 99.0f;
+        }
+        NativeHal::network().setLinkUp(seconds < options.outageFrom || seconds >= options.outageTo);
+        if (options.rebootAt && seconds >= options.rebootAt && !rebooted) {
+            rebooted = true;
+            NativeHal::system().restart();
+        }
+        if (NativeHal::system().sleepRequested) {
+            // Deep sleep: the clock jumps to the timer wake, which boots through setup() again
+            NativeHal::system().sleepRequested = false;
+            NativeHal::system().timerWake = true;
+            if (sleepingSince == 0) sleepingSince = micros();
+            NativeHal::network().powerOff();
+            NativeHal::http().disconnect();
+            NativeHal::clock().advanceMicros(NativeHal::system().sleepMicros);
+            setup();
+            checkSpike();
+            continue;
+        }
+
+        // Real CPU time of the pass, and the virtual time it spent waiting on hardware or the network
+        // (the scheduler's sleep until the next deadline is not a stall)
+        unsigned long virtualStart = micros();
+        unsigned long idleStart = EcoMonitor::scheduler.idleMicros();
+        auto start = std::chrono::steady_clock::now();
+        loop();
+        auto end = std::chrono::steady_clock::now();
+        latencies.push_back((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        unsigned long stall = micros() - virtualStart - (EcoMonitor::scheduler.idleMicros() - idleStart);
+        loopStallTotal += stall;
+        if (stall > loopStallMax) loopStallMax = stall;
+
+        // Tasks run between two passes, standing in for the second core
+        unsigned long taskStart = micros();
+        NativeHal::system().runTasks();
+        taskBusyTotal += micros() - taskStart;
+        NativeHal::network().runEvents();
+        checkSpike();
+        checkCommands();
+
+        // Handlers run on the server task on the device, so the requests are not part of the timed pass
+        FakeWebServer& portal = NativeHal::webServer();
+        if (portal.started && !subscribersConnected) {
+            subscribersConnected = true;
+            for (unsigned long n = 0; n < options.subscribers + options.slowSubscribers; n++) {
+                portal.connectSubscriber(n >= options.subscribers);
+            }
+        }
+        portal.drainStreams();
+        if (options.portalPollSeconds && portal.started && millis() - lastPortalPoll >= options.portalPollSeconds * 1000) {
+            lastPortalPoll = millis();
+            NativeHal::AllocationStats handlerStart = NativeHal::allocations();
+            if (portal.request(false, "/api/reading") != 200 || portal.request(false, "/api/status") != 200) portalErrors++;
+            portalAllocations += NativeHal::allocations().allocations - handlerStart.allocations;
+        }
+
+        if (NativeHal::system().restartRequested) {
+            NativeHal::system().restartRequested = false;
+            NativeHal::system().timerWake = false;
+            restarts++;
+            setup();
+        }
+    }
+
+    NativeHal::AllocationStats after = NativeHal::allocations();
+    uint32_t freeHeap = NativeHal::system().freeHeap();
+    uint32_t minFreeHeap = NativeHal::system().minFreeHeap();
+    uint32_t largestFreeBlock = NativeHal::system().largestFreeBlock();
+
+    // Before the report's own allocations, which the heap gauges would count
+    int metricsCode = 0;
+    std::string metrics;
+    if (options.metrics && NativeHal::webServer().started) {
+        metricsCode = NativeHal::webServer().request(false, "/metrics");
+        metrics = NativeHal::webServer().lastBody;
+    }
+    double virtualSeconds = (millis() - bootMillis) / 1000.0;
+
+    std::vector<uint64_t> sorted(latencies);
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0;
+    for (uint64_t ns : sorted) sum += ns;
+    size_t n = sorted.size();
+
+    const FakeHttp& http = NativeHal::http();
+    const FakeDisplay& display = NativeHal::display();
+
+    printf("iterations:            %lu (%.0f s virtual, %lu restarts)\n", options.iterations, virtualSeconds, restarts);
+    printf("loop latency (us):     min %.2f  mean %.2f  p50 %.2f  p99 %.2f  max %.2f\n",
+           sorted[0] / 1000.0, sum / n / 1000.0, sorted[n / 2] / 1000.0, sorted[n * 99 / 100] / 1000.0, sorted[n - 1] / 1000.0);
+    printf("loop stalls (virtual): max %.1f ms, total %.1f ms; tasks busy %.1f ms\n",
+           loopStallMax / 1000.0, loopStallTotal / 1000.0, taskBusyTotal / 1000.0);
+    printf("heap:                  %lu allocations (%.3f per iteration), %llu bytes, %+lld bytes live\n",
+           after.allocations - before.allocations, (double)(after.allocations - before.allocations) / n,
+           after.bytesAllocated - before.bytesAllocated, after.bytesInUse - before.bytesInUse);
+    printf("heap watermarks:       %u free, %u lowest free, %u largest block\n",
+           (unsigned)freeHeap, (unsigned)minFreeHeap, (unsigned)largestFreeBlock);
+    printf("uploads:               %lu requests, %lu bytes sent, %lu bytes received, %.1f uploads/virtual hour\n",
+           http.requests, http.bytesSent, http.bytesReceived, virtualSeconds > 0 ? http.requests * 3600.0 / virtualSeconds : 0.0);
+    printf("connections:           %lu fresh, %lu reused, %lu stale retries, %lu handshakes\n",
+           EcoMonitor::connectionStats.fresh, EcoMonitor::connectionStats.reused,
+           EcoMonitor::connectionStats.staleRetries, http.handshakes);
+    printf("wifi:                  %lu connects (%lu to the cached access point), boot to first upload %lu ms\n",
+           NativeHal::network().connects, NativeHal::network().hintedConnects, EcoMonitor::bootToFirstUpload);
+    const Scheduler& scheduler = EcoMonitor::scheduler;
+    printf("loop idle:             %.1f%% of the time asleep until the next deadline\n",
+           virtualSeconds > 0 ? scheduler.idleMicros() / 1e4 / virtualSeconds : 0.0);
+    for (size_t id = 0; id < scheduler.jobs(); id++) {
+        const JobStats& job = scheduler.stats(id);
+        printf("job %-18s %6lu runs, late mean %.2f max %.2f ms, jitter %.2f ms, run mean %.2f max %.2f ms, %lu missed\n",
+               job.name, job.runs, job.runs ? job.lateMicros / 1000.0 / job.runs : 0.0, job.maxLateMicros / 1000.0,
+               job.jitterMicros / 1000.0, job.runs ? job.runMicros / 1000.0 / job.runs : 0.0,
+               job.maxRunMicros / 1000.0, job.missed);
+    }
+    const FrameStats& frames = EcoMonitor::screen.stats();
+    printf("display:               %lu frames sent, %lu unchanged skipped, %lu bytes pushed\n",
+           display.frames, frames.skipped, display.bytesSent);
+    printf("display frame:         mean %.0f bytes %.0f us, max %lu us\n",
+           frames.frames ? (double)frames.bytes / frames.frames : 0.0,
+           frames.frames ? (double)frames.micros / frames.frames : 0.0, frames.maxMicros);
+    if (options.portalPollSeconds) {
+        const FakeWebServer& portal = NativeHal::webServer();
+        printf("portal:                %lu requests (%lu failed), %lu bytes served, %lu allocations in the handlers\n",
+               portal.requests, portalErrors, portal.bytesServed, portalAllocations);
+        printf("portal last response:  %s\n", portal.lastBody.c_str());
+    }
+    if (options.subscribers + options.slowSubscribers > 0) {
+        LiveStreamStats stream = LiveStream::stats();
+        printf("live stream:           %lu samples, %lu messages (%lu bytes), %lu subscribers dropped, %lu refused, %u left\n",
+               stream.samples, stream.messages, stream.bytes, stream.dropped, stream.refused,
+               (unsigned)LiveStream::subscribers());
+    }
+    printf("journal:               %u pending, %u dropped, %lu bytes written, %lu sector erases\n",
+           (unsigned)EcoMonitor::journal.pending(), (unsigned)EcoMonitor::journal.dropped(),
+           NativeHal::blockStore().bytesWritten, NativeHal::blockStore().sectorErases);
+    printf("nvs:                   %lu reads (%.1f per iteration), %lu writes\n", storage.reads - storageReadsBefore,
+           (double)(storage.reads - storageReadsBefore) / n, storage.writes - storageWritesBefore);
+    const WakeStats& wakes = DutyCycle::stats();
+    if (wakes.wakes > 0) {
+        unsigned long sampleWakes = wakes.wakes - wakes.radioWakes;
+        printf("deep sleep:            %lu wakes (%lu with Wi-Fi), awake %.2f%% of the time after the first sleep\n",
+               (unsigned long)wakes.wakes, (unsigned long)wakes.radioWakes,
+               100.0 * (wakes.awakeMicros + wakes.radioAwakeMicros) / (micros() - sleepingSince));
+        printf("wake to sleep (ms):    sample only mean %.1f max %.1f, with Wi-Fi mean %.1f max %.1f\n",
+               sampleWakes ? wakes.awakeMicros / 1000.0 / sampleWakes : 0.0, wakes.maxAwakeMicros / 1000.0,
+               wakes.radioWakes ? wakes.radioAwakeMicros / 1000.0 / wakes.radioWakes : 0.0, wakes.maxRadioAwakeMicros / 1000.0);
+    }
+    Histogram alarms = Profiler::histogram(PROFILE_ALARM_UPLOAD);
+    if (options.alarmLevel > 0 || options.alarmRise > 0) {
+        printf("alarm:                 %lu uploads, sample to server mean %.1f max %.1f ms",
+               (unsigned long)alarms.count, alarms.count ? alarms.sumMicros / 1000.0 / alarms.count : 0.0,
+               alarms.maxMicros / 1000.0);
+        if (spikeMillis) printf(", spike to server %lu ms", spikeToServer);
+        printf("\n");
+    }
+    if (options.mqtt) {
+        const FakeMqtt& broker = NativeHal::mqtt();
+        auto status = broker.retainedMessages.find(std::string(MQTT_TOPIC_PREFIX "/") + device_id + "/status");
+        printf("mqtt:                  %lu connects, %lu commands received, %lu publishes (%lu bytes), status %s\n",
+               broker.connects, MqttChannel::received(), broker.published, broker.bytesPublished,
+               status != broker.retainedMessages.end() ? status->second.c_str() : "none");
+    }
+    if (options.commandCount) {
+        printf("commands:              %lu of %lu run %s, first after %lu ms, last after %lu ms\n",
+               commandsRun, options.commandCount, commandsInOrder ? "in order" : "OUT OF ORDER", firstCommandMs, lastCommandMs);
+    }
+    printf("sensor bus:            %lu ADC reads, %lu 1-wire conversions (%lu ms blocked), %lu AM2320 reads\n",
+           NativeHal::adc().reads, NativeHal::tempProbe().conversions, NativeHal::tempProbe().blockedMillis,
+           NativeHal::humidityProbe().transactions);
+    if (options.metrics) {
+        printf("metrics:               HTTP %d, %u bytes\n%s", metricsCode, (unsigned)metrics.size(),
+               metricsCode == 200 ? metrics.c_str() : "");
+    }
+    return 0;
+}
+
+#endif
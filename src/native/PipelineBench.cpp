@@ -0,0 +1,280 @@
+/*
+ * File: PipelineBench.cpp
+ * Description: Host benchmark and regression check of the reading pipeline (program --bench FILE... [--days N]
+ *              [--baseline FILE] [--write-baseline FILE] [--tolerance PCT] [--throughput-tolerance PCT]).
+ *              Each exported trace is stretched to the device's sample tick and repeated until it covers
+ *              --days of device time: the fake probe of the trace's sensor (MQ-7 by ADC voltage, DS18B20,
+ *              AM2320) is set to the value interpolated between two exported readings, the real sensor class
+ *              converts it and the Sampler takes it, one sample per LOOP_SAMPLE_PERIOD of virtual time. Every
+ *              exported interval is closed into one Reading, which is then encoded as an upload body in each
+ *              encoding; the server's answer is decoded and every COMMAND_EVERY-th answer carries a command for
+ *              handleApiCommand(). Per trace and encoding the program prints the throughput (the fastest of
+ *              UPLOAD_ROUNDS rounds), the allocations per reading and the bytes per reading on the wire (body
+ *              plus answer). With --baseline it exits with 1 if allocations or bytes per reading grew by more
+ *              than --tolerance percent (and, with --throughput-tolerance, if readings per second dropped by
+ *              more than that).
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "PipelineBench.h"
+#include "Dataset.h"
+#include "NativeHal.h"
+#include "ecomonitor/EcoMonitor.h"
+#include "ecomonitor/Payload.h"
+#include "ecomonitor/sensors/AM2320_Sensor.h"
+#include "ecomonitor/sensors/DS18B20_Sensor.h"
+#include "ecomonitor/sensors/MQ7_Sensor.h"
+
+static const unsigned long COMMAND_EVERY = 16;    // Readings per answer with a command, a few a day
+static const int UPLOAD_ROUNDS = 5;               // The fastest round counts, the others absorb host noise
+static const char* const DEVICE_ID = "XX-4085A0A5";
+static const char* const PLAIN_ANSWER = "{\"status\":\"success\"}";
+static const char* const COMMAND_ANSWERS[] = {
+    "{\"command\":\"change_deadband\",\"payload\":\"0\"}",
+    "{\"command\":\"change_rate_band\",\"payload\":\"0\"}",
+    "{\"command\":\"enable_screen\",\"payload\":\"\"}",
+};
+
+static MQ7_Sensor mq7;
+static DS18B20_Sensor ds18b20;
+static AM2320_Sensor am2320;
+
+struct BenchResult {
+    std::string trace;          // File name without the directory
+    const char* encoding;
+    unsigned long readings;
+    double samplesPerSecond;
+    double readingsPerSecond;
+    double allocationsPerReading;
+    double bytesPerReading;
+};
+
+static const char* encodingName(PayloadEncoding encoding) {
+    return encoding == PAYLOAD_MSGPACK ? "msgpack" : "json";
+}
+
+static std::string baseName(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+// Inverse of the MQ-7 curve in MQ7_Sensor.cpp, as the raw 12-bit ADC reading of the fake
+static int mq7RawFromPpm(float ppm) {
+    if (ppm <= 0) return 0;
+    float rs = RO_CLEAN_AIR * powf(ppm / 100.0f, -1.0f / 2.95f);
+    float milliVolts = 5000.0f * RL / (rs + RL);
+    return constrain((int)lroundf(milliVolts * 4095.0f / 3300.0f), 0, 4095);
+}
+
+// The sensor of the trace and how to make its fake probe read a value
+static SensorInterface* sensorFor(const std::string& trace, void (**setValue)(float)) {
+    if (trace.find("gas") != std::string::npos) {
+        *setValue = [](float value) { NativeHal::adc().setValue(mq7RawFromPpm(value)); };
+        return &mq7;
+    }
+    if (trace.find("temperature") != std::string::npos) {
+        *setValue = [](float value) { NativeHal::tempProbe().value = value; };
+        return &ds18b20;
+    }
+    if (trace.find("humidity") != std::string::npos) {
+        *setValue = [](float value) { NativeHal::humidityProbe().value = value; };
+        return &am2320;
+    }
+    return nullptr;
+}
+
+// Sensor conversion and sampling over the whole time span; one Reading per exported interval
+static double sampleTrace(const std::vector<Sample>& trace, SensorInterface* sensor, void (*setValue)(float),
+                          unsigned long days, std::vector<Reading>& readings, unsigned long& allocations) {
+    unsigned long traceInterval = trace.back().timestamp / (trace.size() - 1);
+    unsigned long samplesPerReading = std::max(1UL, traceInterval / LOOP_SAMPLE_PERIOD);
+    unsigned long count = days * 86400000UL / (samplesPerReading * LOOP_SAMPLE_PERIOD);
+    readings.clear();
+    readings.reserve(count);
+
+    NativeHal::adc().setNoise(0);
+    setValue(trace[0].value);
+    sensor->begin();
+    Sampler sampler;
+    sampler.begin(sensor);
+
+    NativeHal::AllocationStats before = NativeHal::allocations();
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long r = 0; r < count; r++) {
+        float from = trace[r % trace.size()].value;
+        float to = trace[(r + 1) % trace.size()].value;
+        for (unsigned long s = 0; s < samplesPerReading; s++) {
+            setValue(from + (to - from) * s / samplesPerReading);
+            NativeHal::clock().advanceMicros(LOOP_SAMPLE_PERIOD * 1000ULL);
+            sampler.sample();
+        }
+        readings.push_back(sampler.closeInterval());
+    }
+    auto end = std::chrono::steady_clock::now();
+    allocations = NativeHal::allocations().allocations - before.allocations;
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return seconds > 0 ? count * samplesPerReading / seconds : 0;
+}
+
+// Upload body, the server's answer and its command for every reading; the seconds it took
+static double uploadReadings(const std::vector<Reading>& readings, PayloadEncoding encoding, unsigned long long& bytes) {
+    static uint8_t body[UPLOAD_PAYLOAD_SIZE];
+    bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long r = 0; r < readings.size(); r++) {
+        bytes += Payload::encodeReadings(DEVICE_ID, &readings[r], 1, encoding, body, sizeof(body));
+
+        const char* answer = r % COMMAND_EVERY == COMMAND_EVERY - 1
+            ? COMMAND_ANSWERS[(r / COMMAND_EVERY) % (sizeof(COMMAND_ANSWERS) / sizeof(COMMAND_ANSWERS[0]))]
+            : PLAIN_ANSWER;
+        size_t answerLength = strlen(answer);
+        bytes += answerLength;
+        ApiCommand command;
+        if (Payload::decodeCommand(answer, answerLength, "application/json", command)) {
+            handleApiCommand(command.command, command.payload);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+static BenchResult benchUploads(const std::vector<Reading>& readings, PayloadEncoding encoding) {
+    BenchResult result = {};
+    result.encoding = encodingName(encoding);
+    result.readings = readings.size();
+
+    unsigned long long bytes = 0;
+    NativeHal::AllocationStats before = NativeHal::allocations();
+    double fastest = uploadReadings(readings, encoding, bytes);
+    result.allocationsPerReading = (double)(NativeHal::allocations().allocations - before.allocations) / readings.size();
+    for (int round = 1; round < UPLOAD_ROUNDS; round++) {
+        fastest = std::min(fastest, uploadReadings(readings, encoding, bytes));
+    }
+    result.readingsPerSecond = fastest > 0 ? readings.size() / fastest : 0;
+    result.bytesPerReading = (double)bytes / readings.size();
+    return result;
+}
+
+// CSV: trace,encoding,allocations_per_reading,bytes_per_reading,readings_per_second
+static bool loadBaseline(const char* path, std::vector<BenchResult>& baseline) {
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        char trace[128], encoding[16];
+        BenchResult entry = {};
+        if (sscanf(line, "%127[^,],%15[^,],%lf,%lf,%lf", trace, encoding, &entry.allocationsPerReading,
+                   &entry.bytesPerReading, &entry.readingsPerSecond) != 5) continue;  // Header
+        PayloadEncoding parsed;
+        if (!Payload::encodingFromName(encoding, parsed)) continue;
+        entry.trace = trace;
+        entry.encoding = encodingName(parsed);
+        baseline.push_back(entry);
+    }
+    fclose(file);
+    return true;
+}
+
+static bool writeBaseline(const char* path, const std::vector<BenchResult>& results) {
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+    fprintf(file, "trace,encoding,allocations_per_reading,bytes_per_reading,readings_per_second\n");
+    for (const BenchResult& result : results) {
+        fprintf(file, "%s,%s,%.4f,%.2f,%.0f\n", result.trace.c_str(), result.encoding,
+                result.allocationsPerReading, result.bytesPerReading, result.readingsPerSecond);
+    }
+    fclose(file);
+    return true;
+}
+
+// Prints every regression; the number of them
+static unsigned long compare(const std::vector<BenchResult>& results, const std::vector<BenchResult>& baseline,
+                             const PipelineBenchOptions& options) {
+    unsigned long regressions = 0;
+    auto check = [&](const BenchResult& result, const char* metric, double value, double reference, bool higherIsWorse,
+                     float tolerance) {
+        double limit = higherIsWorse ? reference * (1 + tolerance / 100.0) : reference * (1 - tolerance / 100.0);
+        bool regressed = higherIsWorse ? value > limit + 1e-9 : value < limit;
+        if (!regressed) return;
+        regressions++;
+        printf("REGRESSION %s %s: %s %.2f, baseline %.2f (tolerance %.0f%%)\n", result.trace.c_str(),
+               result.encoding, metric, value, reference, tolerance);
+    };
+
+    for (const BenchResult& result : results) {
+        const BenchResult* reference = nullptr;
+        for (const BenchResult& entry : baseline) {
+            if (entry.trace == result.trace && !strcmp(entry.encoding, result.encoding)) reference = &entry;
+        }
+        if (!reference) {
+            printf("no baseline for %s %s\n", result.trace.c_str(), result.encoding);
+            continue;
+        }
+        check(result, "allocations/reading", result.allocationsPerReading, reference->allocationsPerReading, true,
+              options.tolerance);
+        check(result, "bytes/reading", result.bytesPerReading, reference->bytesPerReading, true, options.tolerance);
+        if (options.throughputTolerance > 0) {
+            check(result, "readings/s", result.readingsPerSecond, reference->readingsPerSecond, false,
+                  options.throughputTolerance);
+        }
+    }
+    return regressions;
+}
+
+int runPipelineBench(const std::vector<const char*>& paths, const PipelineBenchOptions& options) {
+    Serial.setQuiet(true);
+    std::vector<BenchResult> results;
+
+    printf("trace              encoding  readings  samples/s  readings/s  allocs/reading  bytes/reading\n");
+    for (const char* path : paths) {
+        std::string trace = baseName(path);
+        std::vector<Sample> samples;
+        void (*setValue)(float) = nullptr;
+        SensorInterface* sensor = sensorFor(trace, &setValue);
+        if (!sensor || !loadDataset(path, samples) || samples.size() < 2) {
+            fprintf(stderr, "Cannot replay %s (gas, humidity or temperature export with two readings or more)\n", path);
+            return 2;
+        }
+
+        std::vector<Reading> readings;
+        unsigned long samplingAllocations = 0;
+        double samplesPerSecond = sampleTrace(samples, sensor, setValue, options.days, readings, samplingAllocations);
+        for (PayloadEncoding encoding : {PAYLOAD_JSON, PAYLOAD_MSGPACK}) {
+            BenchResult result = benchUploads(readings, encoding);
+            result.trace = trace;
+            result.samplesPerSecond = samplesPerSecond;
+            result.allocationsPerReading += (double)samplingAllocations / readings.size();
+            printf("%-18s %-8s  %8lu  %9.0f  %10.0f  %14.4f  %13.1f\n", trace.c_str(), result.encoding,
+                   result.readings, result.samplesPerSecond, result.readingsPerSecond, result.allocationsPerReading,
+                   result.bytesPerReading);
+            results.push_back(result);
+        }
+    }
+
+    if (options.writeBaseline) {
+        if (!writeBaseline(options.writeBaseline, results)) {
+            fprintf(stderr, "Cannot write %s\n", options.writeBaseline);
+            return 2;
+        }
+        printf("baseline written to %s\n", options.writeBaseline);
+    }
+    if (options.baseline) {
+        std::vector<BenchResult> baseline;
+        if (!loadBaseline(options.baseline, baseline)) {
+            fprintf(stderr, "Cannot read %s\n", options.baseline);
+            return 2;
+        }
+        unsigned long regressions = compare(results, baseline, options);
+        printf("%lu regressions against %s\n", regressions, options.baseline);
+        if (regressions > 0) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+/*
+ * File: PipelineBench.h
+ * Description: Replay of the exported traces through the reading pipeline with a regression check, see
+ *              PipelineBench.cpp.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef NATIVE_PIPELINE_BENCH_H
+#define NATIVE_PIPELINE_BENCH_H
+
+#include <vector>
+
+struct PipelineBenchOptions {
+    unsigned long days = 90;                // Device time simulated per trace
+    const char* baseline = nullptr;         // Compare against this file
+    const char* writeBaseline = nullptr;    // Write the results as the new baseline
+    float tolerance = 5;                    // % allocations and bytes per reading may grow over the baseline
+    float throughputTolerance = 0;          // % readings per second may drop, 0 leaves throughput unchecked
+};
+
+int runPipelineBench(const std::vector<const char*>& paths, const PipelineBenchOptions& options);  // Process exit code
+
+#endif
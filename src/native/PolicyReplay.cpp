@@ -0,0 +1,87 @@
+/*
+ * File: PolicyReplay.cpp
+ * Description: Host replay of the upload policies (program --replay FILE... [--heartbeat MINUTES]). Every
+ *              exported reading is fed to ReportPolicy as if it were a sample; the server side is assumed to
+ *              hold the last uploaded value until the next one arrives. For each policy the number of uploads
+ *              and the error of that reconstruction against the full trace are printed. The bands are given in
+ *              multiples of the trace's standard deviation, so one sweep fits gas, humidity and temperature.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#include "PolicyReplay.h"
+#include "Dataset.h"
+#include "ecomonitor/IntervalStats.h"
+#include "ecomonitor/ReportPolicy.h"
+
+struct PolicyCase {
+    const char* name;
+    bool fixed;           // Upload every reading, as before the policy existed
+    float deadbandSigma;
+    float rateSigmaPerHour;
+};
+
+static const PolicyCase policies[] = {
+    {"every reading", true, 0, 0},
+    {"heartbeat only", false, 0, 0},
+    {"deadband 0.25 sd", false, 0.25f, 0},
+    {"deadband 0.5 sd", false, 0.5f, 0},
+    {"deadband 1 sd", false, 1.0f, 0},
+    {"rate 1 sd/h", false, 0, 1.0f},
+    {"deadband 0.5 sd + rate 1 sd/h", false, 0.5f, 1.0f},
+};
+
+struct ReplayResult {
+    unsigned long uploads = 0;
+    double squaredError = 0;
+    float maxError = 0;
+};
+
+static ReplayResult replay(const std::vector<Sample>& samples, const PolicyCase& policyCase, float sigma,
+                           unsigned long heartbeatMinutes) {
+    ReportPolicy policy;
+    policy.setHeartbeat(policyCase.fixed ? 0 : heartbeatMinutes * 60UL * 1000UL);
+    policy.setDeadband(policyCase.deadbandSigma * sigma);
+    policy.setRateBand(policyCase.rateSigmaPerHour * sigma / 60.0f);
+
+    ReplayResult result;
+    float held = 0;
+    for (const Sample& sample : samples) {
+        if (policy.check(sample) != REASON_NONE) {
+            result.uploads++;
+            held = sample.value;
+        }
+        float error = fabsf(sample.value - held);
+        result.squaredError += (double)error * error;
+        if (error > result.maxError) result.maxError = error;
+    }
+    return result;
+}
+
+int runPolicyReplay(const std::vector<const char*>& paths, unsigned long heartbeatMinutes) {
+    for (const char* path : paths) {
+        std::vector<Sample> samples;
+        if (!loadDataset(path, samples)) {
+            fprintf(stderr, "Cannot read dataset %s\n", path);
+            return 2;
+        }
+
+        IntervalStats trace;
+        for (const Sample& sample : samples) trace.add(sample.value);
+        float sigma = trace.stddev();
+
+        printf("%s: %u readings over %.1f h, mean %.4g, sd %.4g, heartbeat %lu min\n", path, (unsigned)samples.size(),
+               (samples.back().epoch - samples.front().epoch) / 3600.0, trace.mean(), sigma, heartbeatMinutes);
+        printf("  %-32s %8s %8s %12s %12s\n", "policy", "uploads", "share", "rms error", "max error");
+        for (const PolicyCase& policyCase : policies) {
+            ReplayResult result = replay(samples, policyCase, sigma, heartbeatMinutes);
+            printf("  %-32s %8lu %7.1f%% %12.4g %12.4g\n", policyCase.name, result.uploads,
+                   100.0 * result.uploads / samples.size(), sqrt(result.squaredError / samples.size()), result.maxError);
+        }
+    }
+    return 0;
+}
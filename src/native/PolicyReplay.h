@@ -0,0 +1,17 @@
+/*
+ * File: PolicyReplay.h
+ * Description: Replays exported readings through upload policies, see PolicyReplay.cpp.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef NATIVE_POLICY_REPLAY_H
+#define NATIVE_POLICY_REPLAY_H
+
+#include <vector>
+
+int runPolicyReplay(const std::vector<const char*>& paths, unsigned long heartbeatMinutes);  // Process exit code
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * File: StreamBench.cpp
+ * Description: Host benchmark of the live stream (program --stream-bench). Publishes samples to 0..LIVE_MAX_CLIENTS
+ *              subscribers that read everything and prints the CPU time per sample and per subscriber. Then checks
+ *              the limits: a subscriber that never reads must be dropped once LIVE_CLIENT_QUEUE messages wait for
+ *              it while the others keep receiving, and one past LIVE_MAX_CLIENTS must be refused. Exits with 1 if
+ *              a limit does not hold.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <chrono>
+#include <stdio.h>
+
+#include "NativeHal.h"
+#include "StreamBench.h"
+#include "ecomonitor/LiveStream.h"
+
+static const unsigned long ROUNDS = 200000;
+
+static double nanosPerSample(FakeWebServer& server) {
+    Sample sample = {0, FakeClock::START_EPOCH, 0};
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < ROUNDS; i++) {
+        sample.timestamp = i * 5000;
+        sample.value = 10.0f + (i % 100) * 0.01f;
+        LiveStream::publish(sample);
+        server.drainStreams();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / ROUNDS;
+}
+
+int runStreamBench() {
+    FakeWebServer& server = NativeHal::webServer();
+    Serial.setQuiet(true);
+    LiveStream::begin();
+
+    printf("subscribers  ns/sample  ns/subscriber  bytes/sample\n");
+    double baseline = 0;
+    for (size_t count = 0; count <= LIVE_MAX_CLIENTS; count++) {
+        if (count > 0) server.connectSubscriber(false);
+        LiveStreamStats before = LiveStream::stats();
+        double nanos = nanosPerSample(server);
+        LiveStreamStats after = LiveStream::stats();
+        if (count == 0) baseline = nanos;
+        printf("%11u  %9.0f  %13.0f  %12.1f\n", (unsigned)count, nanos, count ? (nanos - baseline) / count : 0.0,
+               (double)(after.bytes - before.bytes) / ROUNDS);
+    }
+
+    // Limits: make room for a slow subscriber, then try one more than fits
+    unsigned long failures = 0;
+    server.streamClose(server.subscribers.begin()->first);
+    uint32_t slow = server.connectSubscriber(true);
+    Sample sample = {0, FakeClock::START_EPOCH, 1.0f};
+    for (int i = 0; i <= LIVE_CLIENT_QUEUE; i++) {
+        LiveStream::publish(sample);
+        server.drainStreams();
+    }
+    bool dropped = !server.subscribers[slow].open;
+    printf("slow subscriber: %s after %d samples, %u others still connected\n", dropped ? "dropped" : "NOT DROPPED",
+           LIVE_CLIENT_QUEUE + 1, (unsigned)LiveStream::subscribers());
+    if (!dropped || LiveStream::subscribers() != LIVE_MAX_CLIENTS - 1) failures++;
+
+    server.connectSubscriber(false);
+    uint32_t extra = server.connectSubscriber(false);
+    bool refused = !server.subscribers[extra].open && LiveStream::stats().refused == 1;
+    printf("subscriber over LIVE_MAX_CLIENTS (%d): %s\n", LIVE_MAX_CLIENTS, refused ? "refused" : "NOT REFUSED");
+    if (!refused) failures++;
+
+    return failures == 0 ? 0 : 1;
+}
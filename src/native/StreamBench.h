@@ -0,0 +1,15 @@
+/*
+ * File: StreamBench.h
+ * Description: Fan-out cost of the live stream per number of subscribers, see StreamBench.cpp.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#pragma once
+
+#ifndef NATIVE_STREAM_BENCH_H
+#define NATIVE_STREAM_BENCH_H
+
+int runStreamBench();  // Process exit code
+
+#endif
@@ -0,0 +1,116 @@
+/*
+ * File: test_main.cpp
+ * Description: Alarm rules (Alarm.h): the level and the rise trip only after ALARM_CONFIRM_SAMPLES samples in a
+ *              row, and the alarm clears below the level by the hysteresis once the value stops rising.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <unity.h>
+
+#include "ecomonitor/Alarm.h"
+
+static AlarmDetector detector;
+static unsigned long now;
+
+// One sample every 250 ms, like GasGuard's alarm sampling
+static AlarmEvent feed(float value) {
+    now += 250;
+    return detector.check({now, 0, value});
+}
+
+static void feedUntil(float value, AlarmEvent expected, int most) {
+    for (int i = 0; i < most; i++) {
+        if (feed(value) == expected) return;
+    }
+    TEST_ASSERT_TRUE_MESSAGE(false, "expected event did not come");
+}
+
+void setUp() {
+    detector = AlarmDetector();
+    detector.setHysteresis(0);
+    detector.setRiseRate(0);
+    now = 0;
+}
+
+void tearDown() {}
+
+static void test_unarmed_never_trips() {
+    TEST_ASSERT_FALSE(detector.armed());
+    for (int i = 0; i < 100; i++) TEST_ASSERT_EQUAL(ALARM_NO_CHANGE, feed(1000.0f * i));
+    TEST_ASSERT_FALSE(detector.active());
+}
+
+static void test_level_needs_confirmation() {
+    detector.setLevel(100);
+    TEST_ASSERT_TRUE(detector.armed());
+    TEST_ASSERT_EQUAL(ALARM_NO_CHANGE, feed(50));
+    // A single noisy reading neither trips nor starts a streak that survives a normal one
+    TEST_ASSERT_EQUAL(ALARM_NO_CHANGE, feed(150));
+    TEST_ASSERT_EQUAL(ALARM_NO_CHANGE, feed(50));
+    TEST_ASSERT_EQUAL(ALARM_NO_CHANGE, feed(150));
+    for (int i = 2; i < ALARM_CONFIRM_SAMPLES; i++) TEST_ASSERT_EQUAL(ALARM_NO_CHANGE, feed(150));
+    TEST_ASSERT_EQUAL(ALARM_TRIPPED, feed(150));
+    TEST_ASSERT_TRUE(detector.active());
+    TEST_ASSERT_EQUAL(CAUSE_LEVEL, detector.cause());
+    TEST_ASSERT_EQUAL(ALARM_NO_CHANGE, feed(150));
+}
+
+static void test_hysteresis_band_holds_the_state() {
+    detector.setLevel(100);
+    detector.setHysteresis(10);
+    feedUntil(120, ALARM_TRIPPED, ALARM_CONFIRM_SAMPLES);
+
+    // Below the level but inside the band: still on
+    for (int i = 0; i < 10; i++) TEST_ASSERT_EQUAL(ALARM_NO_CHANGE, feed(95));
+    TEST_ASSERT_TRUE(detector.active());
+
+    feedUntil(89, ALARM_CLEARED, ALARM_CONFIRM_SAMPLES);
+    TEST_ASSERT_FALSE(detector.active());
+    TEST_ASSERT_EQUAL(CAUSE_NONE, detector.cause());
+
+    // Back into the band does not trip it again
+    for (int i = 0; i < 10; i++) TEST_ASSERT_EQUAL(ALARM_NO_CHANGE, feed(95));
+}
+
+// The rise is measured over ALARM_RISE_WINDOW, so it needs that much history before it can trip
+static void test_rise_trips_below_the_level() {
+    detector.setLevel(1000);
+    detector.setRiseRate(60);   // Units per minute
+    const int windowSamples = ALARM_RISE_WINDOW / 250;
+    for (int i = 0; i < windowSamples; i++) TEST_ASSERT_EQUAL(ALARM_NO_CHANGE, feed(10));
+
+    // 2 units per second is 120 per minute
+    float value = 10;
+    AlarmEvent event = ALARM_NO_CHANGE;
+    for (int i = 0; i < windowSamples && event == ALARM_NO_CHANGE; i++) {
+        value += 0.5f;
+        event = feed(value);
+    }
+    TEST_ASSERT_EQUAL(ALARM_TRIPPED, event);
+    TEST_ASSERT_EQUAL(CAUSE_RISE, detector.cause());
+    TEST_ASSERT_TRUE(value < 1000);
+    TEST_ASSERT_TRUE(detector.rise() >= 60);
+
+    // Flat again: the rise over the window falls off and the alarm clears
+    feedUntil(value, ALARM_CLEARED, 2 * windowSamples);
+}
+
+static void test_reset_forgets_state() {
+    detector.setLevel(100);
+    feedUntil(150, ALARM_TRIPPED, ALARM_CONFIRM_SAMPLES);
+    detector.reset();
+    TEST_ASSERT_FALSE(detector.active());
+    TEST_ASSERT_EQUAL(CAUSE_NONE, detector.cause());
+    TEST_ASSERT_EQUAL_FLOAT(100, detector.level());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_unarmed_never_trips);
+    RUN_TEST(test_level_needs_confirmation);
+    RUN_TEST(test_hysteresis_band_holds_the_state);
+    RUN_TEST(test_rise_trips_below_the_level);
+    RUN_TEST(test_reset_forgets_state);
+    return UNITY_END();
+}
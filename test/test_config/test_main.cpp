@@ -0,0 +1,123 @@
+/*
+ * File: test_main.cpp
+ * Description: Configuration blob (Config.h): a device on the per-key layout of the released firmware is migrated
+ *              once and its old keys are erased, the blob is read back as written, and stored values out of range
+ *              fall back to defaults.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <unity.h>
+
+#include "NativeHal.h"
+#include "ecomonitor/Config.h"
+#include "ecomonitor/Uploader.h"
+
+static FakeStorage& storage = NativeHal::storage();
+
+// What the firmware before the blob left in NVS after the configuration portal
+static void storeReleasedLayout(const char* readingTime) {
+    storage.putBool("isConfigured", true);
+    storage.putString("sta_ssid", String("greenhouse"));
+    storage.putString("sta_password", String("secret"));
+    storage.putString("reading_time", String(readingTime));
+    storage.putString("api_base_url", String("https://example.org/api"));
+}
+
+void setUp() {
+    Serial.setQuiet(true);
+    storage.clear();
+}
+
+void tearDown() {}
+
+static bool stored(const char* key) {
+    uint8_t byte;
+    return storage.getBytes(key, &byte, 1) > 0;
+}
+
+static void test_fresh_device_gets_defaults() {
+    Config::load();
+    const DeviceConfig& config = Config::get();
+    TEST_ASSERT_EQUAL_UINT(CONFIG_VERSION, config.version);
+    TEST_ASSERT_FALSE(config.configured);
+    TEST_ASSERT_EQUAL_UINT(15, config.readingMinutes);
+    TEST_ASSERT_EQUAL_UINT(UPLOAD_BATCH_SIZE, config.batchSize);
+    TEST_ASSERT_EQUAL_STRING("", config.apiBaseUrl);
+}
+
+static void test_released_layout_is_migrated_once() {
+    storeReleasedLayout("30");
+    Config::load();
+    const DeviceConfig& config = Config::get();
+    TEST_ASSERT_TRUE(config.configured);
+    TEST_ASSERT_EQUAL_STRING("greenhouse", config.ssid);
+    TEST_ASSERT_EQUAL_STRING("secret", config.password);
+    TEST_ASSERT_EQUAL_STRING("https://example.org/api", config.apiBaseUrl);
+    TEST_ASSERT_EQUAL_UINT(30, config.readingMinutes);
+    TEST_ASSERT_FALSE(Config::flush());     // The blob was stored by load()
+    TEST_ASSERT_TRUE(stored("device"));
+    TEST_ASSERT_FALSE(stored("isConfigured"));
+    TEST_ASSERT_FALSE(stored("sta_ssid"));
+    TEST_ASSERT_FALSE(stored("sta_password"));
+    TEST_ASSERT_FALSE(stored("reading_time"));
+    TEST_ASSERT_FALSE(stored("api_base_url"));
+
+    // The next boot reads the blob, a stray old key does not matter
+    storage.putString("reading_time", String("45"));
+    Config::load();
+    TEST_ASSERT_EQUAL_UINT(30, Config::get().readingMinutes);
+    TEST_ASSERT_FALSE(Config::flush());
+}
+
+static void test_changes_survive_a_reboot() {
+    storeReleasedLayout("15");
+    Config::load();
+    Config::edit().batchSize = 8;
+    Config::edit().alarmLevel = 120.5f;
+    strlcpy(Config::edit().mqttBroker, "broker.lan", sizeof(DeviceConfig::mqttBroker));
+    TEST_ASSERT_TRUE(Config::flush());
+
+    Config::load();
+    const DeviceConfig& config = Config::get();
+    TEST_ASSERT_EQUAL_UINT(8, config.batchSize);
+    TEST_ASSERT_EQUAL_FLOAT(120.5f, config.alarmLevel);
+    TEST_ASSERT_EQUAL_STRING("broker.lan", config.mqttBroker);
+    TEST_ASSERT_EQUAL_STRING("greenhouse", config.ssid);
+}
+
+static void test_out_of_range_values_fall_back() {
+    storeReleasedLayout("0");
+    storage.putString("sta_ssid", String(""));
+    Config::load();
+    const DeviceConfig& config = Config::get();
+    TEST_ASSERT_EQUAL_UINT(15, config.readingMinutes);
+    TEST_ASSERT_FALSE(config.configured);    // No network to join without an SSID
+}
+
+// A blob of another version or size is not trusted; the per-key settings are read again
+static void test_unknown_blob_is_replaced() {
+    storeReleasedLayout("20");
+    DeviceConfig foreign = {};
+    foreign.version = CONFIG_VERSION + 1;
+    foreign.readingMinutes = 99;
+    storage.putBytes("device", &foreign, sizeof(foreign));
+    Config::load();
+    TEST_ASSERT_EQUAL_UINT(CONFIG_VERSION, Config::get().version);
+    TEST_ASSERT_EQUAL_UINT(20, Config::get().readingMinutes);
+
+    storeReleasedLayout("25");
+    storage.putBytes("device", &foreign, sizeof(foreign) - 4);
+    Config::load();
+    TEST_ASSERT_EQUAL_UINT(25, Config::get().readingMinutes);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fresh_device_gets_defaults);
+    RUN_TEST(test_released_layout_is_migrated_once);
+    RUN_TEST(test_changes_survive_a_reboot);
+    RUN_TEST(test_out_of_range_values_fall_back);
+    RUN_TEST(test_unknown_blob_is_replaced);
+    return UNITY_END();
+}
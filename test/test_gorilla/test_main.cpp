@@ -0,0 +1,126 @@
+/*
+ * File: test_main.cpp
+ * Description: Gorilla blocks (Gorilla.h): bit-exact round trips over every timestamp and value encoding, a full
+ *              block refusing the next point unchanged, and damaged blocks.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <math.h>
+#include <string.h>
+#include <unity.h>
+
+#include "ecomonitor/Gorilla.h"
+
+static uint32_t bitsOf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+template <size_t N>
+static void checkRoundTrip(const GorillaBlock<N>& block, const uint32_t* epochs, const float* values, size_t count) {
+    GorillaReader reader = block.reader();
+    TEST_ASSERT_EQUAL_UINT(count, reader.count());
+    for (size_t i = 0; i < count; i++) {
+        uint32_t epoch;
+        float value;
+        TEST_ASSERT_TRUE(reader.next(epoch, value));
+        TEST_ASSERT_EQUAL_UINT32(epochs[i], epoch);
+        TEST_ASSERT_EQUAL_HEX32(bitsOf(values[i]), bitsOf(value));
+    }
+    uint32_t epoch;
+    float value;
+    TEST_ASSERT_FALSE(reader.next(epoch, value));
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_empty_block() {
+    GorillaBlock<64> block = {};
+    TEST_ASSERT_EQUAL_UINT(0, block.size());
+    TEST_ASSERT_EQUAL_UINT(0, block.length());
+    TEST_ASSERT_FALSE(block.isFull());
+    uint32_t epoch;
+    float value;
+    GorillaReader reader = block.reader();
+    TEST_ASSERT_FALSE(reader.next(epoch, value));
+}
+
+// After the first delta ('10' + 7 bits), a fixed interval and a repeated value cost one bit each
+static void test_regular_series_is_compact() {
+    GorillaBlock<64> block = {};
+    uint32_t epochs[100];
+    float values[100];
+    for (size_t i = 0; i < 100; i++) {
+        epochs[i] = 1768150000 + 60 * i;
+        values[i] = 21.5f;
+        TEST_ASSERT_TRUE(block.append(epochs[i], values[i]));
+    }
+    TEST_ASSERT_EQUAL_UINT(GORILLA_HEADER_SIZE + (9 + 1 + 98 * 2 + 7) / 8, block.length());
+    checkRoundTrip(block, epochs, values, 100);
+}
+
+// Every bucket of the difference of deltas, both value windows, clock steps back and special floats
+static void test_every_encoding_round_trips() {
+    const uint32_t epochs[] = {1000, 1060, 1120, 1190, 1100, 1500, 1501, 5000, 5001, 70000, 70000, 4000000000u, 10};
+    const float values[] = {21.5f, 21.5625f, 21.5f, -3.25f, 0.0f, -0.0f, 1e-30f, 3.4e38f, NAN, INFINITY,
+                            21.5f, 21.5f, 0.001f};
+    const size_t count = sizeof(epochs) / sizeof(epochs[0]);
+    GorillaBlock<256> block = {};
+    for (size_t i = 0; i < count; i++) {
+        TEST_ASSERT_TRUE(block.append(epochs[i], values[i]));
+    }
+    checkRoundTrip(block, epochs, values, count);
+}
+
+static void test_full_block_refuses_unchanged() {
+    GorillaBlock<32> block = {};
+    uint32_t epochs[64];
+    float values[64];
+    size_t count = 0;
+    while (count < 64) {
+        epochs[count] = 1768150000 + 37 * count * count;  // Growing deltas, no point is cheap
+        values[count] = count * 1.7f - 20.0f;
+        if (!block.append(epochs[count], values[count])) break;
+        count++;
+    }
+    TEST_ASSERT_TRUE(count > 1 && count < 64);
+    TEST_ASSERT_TRUE(block.isFull());
+
+    uint8_t before[32];
+    memcpy(before, block.data(), sizeof(before));
+    size_t length = block.length();
+    TEST_ASSERT_FALSE(block.append(epochs[count], values[count]));
+    TEST_ASSERT_EQUAL_MEMORY(before, block.data(), sizeof(before));
+    TEST_ASSERT_EQUAL_UINT(length, block.length());
+    checkRoundTrip(block, epochs, values, count);
+}
+
+static void test_truncated_block_stops() {
+    GorillaBlock<128> block = {};
+    for (uint32_t i = 0; i < 20; i++) block.append(1000 + 60 * i + (i % 3), 20.0f + i * 0.37f);
+
+    GorillaReader reader(block.data(), block.length() - 3);
+    TEST_ASSERT_EQUAL_UINT(20, reader.count());
+    uint32_t epoch;
+    float value;
+    size_t decoded = 0;
+    while (reader.next(epoch, value)) decoded++;
+    TEST_ASSERT_TRUE(decoded < 20);
+
+    GorillaReader tooShort(block.data(), GORILLA_HEADER_SIZE - 1);
+    TEST_ASSERT_EQUAL_UINT(0, tooShort.count());
+    TEST_ASSERT_FALSE(tooShort.next(epoch, value));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_block);
+    RUN_TEST(test_regular_series_is_compact);
+    RUN_TEST(test_every_encoding_round_trips);
+    RUN_TEST(test_full_block_refuses_unchanged);
+    RUN_TEST(test_truncated_block_stops);
+    return UNITY_END();
+}
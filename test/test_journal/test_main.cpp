@@ -0,0 +1,169 @@
+/*
+ * File: test_main.cpp
+ * Description: Flash journal (Journal.h) on the fake block store: order, the ring wrapping over its oldest
+ *              records, records failing their CRC, the pending backlog surviving a reboot, and every byte being
+ *              erased before it is written.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <stddef.h>
+#include <unity.h>
+
+#include "NativeHal.h"
+#include "ecomonitor/Journal.h"
+
+static const size_t BATCH = 32;     // Readings per peek, as many as an upload batch takes
+static FakeBlockStore& store = NativeHal::blockStore();
+static Journal journal;
+
+static Reading reading(uint32_t epoch) {
+    Reading reading = {};
+    reading.timestamp = 5000 + epoch;
+    reading.epoch = epoch;
+    reading.value = epoch * 0.5f;
+    reading.min = reading.value - 1;
+    reading.max = reading.value + 1;
+    reading.mean = reading.value;
+    reading.stddev = 0.25f;
+    reading.count = 3;
+    reading.channelCount = 1;
+    reading.alarm = ALARM_FLAG_RAISED;
+    return reading;
+}
+
+static size_t slotOffset(uint32_t sequence) {
+    return (size_t)(sequence % JOURNAL_CAPACITY) * sizeof(JournalRecord);
+}
+
+void setUp() {
+    Serial.setQuiet(true);
+    NativeHal::storage().clear();
+    store.eraseAll();
+    store.unerasedWrites = 0;
+    journal = Journal();
+    TEST_ASSERT_TRUE(journal.begin());
+}
+
+void tearDown() {}
+
+static void test_oldest_first() {
+    for (uint32_t epoch = 1; epoch <= 5; epoch++) journal.append(reading(epoch));
+    TEST_ASSERT_EQUAL_UINT(5, journal.pending());
+
+    Reading readings[BATCH];
+    TEST_ASSERT_EQUAL_UINT(3, journal.peek(readings, 3));
+    for (uint32_t i = 0; i < 3; i++) {
+        Reading expected = reading(i + 1);
+        TEST_ASSERT_EQUAL_UINT32(expected.epoch, readings[i].epoch);
+        TEST_ASSERT_EQUAL_FLOAT(expected.value, readings[i].value);
+        TEST_ASSERT_EQUAL_FLOAT(expected.min, readings[i].min);
+        TEST_ASSERT_EQUAL_FLOAT(expected.max, readings[i].max);
+        TEST_ASSERT_EQUAL_FLOAT(expected.stddev, readings[i].stddev);
+        TEST_ASSERT_EQUAL_UINT(expected.count, readings[i].count);
+        // Only what a record keeps: no channels, and a replay is not an alarm
+        TEST_ASSERT_EQUAL_UINT(0, readings[i].channelCount);
+        TEST_ASSERT_EQUAL(ALARM_FLAG_NONE, readings[i].alarm);
+    }
+
+    journal.pop(3);
+    TEST_ASSERT_EQUAL_UINT(2, journal.pending());
+    TEST_ASSERT_EQUAL_UINT(2, journal.peek(readings, BATCH));
+    TEST_ASSERT_EQUAL_UINT32(4, readings[0].epoch);
+    journal.pop(5);
+    TEST_ASSERT_EQUAL_UINT(0, journal.pending());
+    TEST_ASSERT_EQUAL_UINT(0, journal.peek(readings, BATCH));
+}
+
+// A full ring erases the sector it wraps into; the oldest pending records in it are counted as dropped
+static void test_wrap_keeps_the_newest() {
+    const uint32_t sector = store.sectorSize() / sizeof(JournalRecord);
+    const uint32_t extra = 10;
+    for (uint32_t epoch = 1; epoch <= JOURNAL_CAPACITY + extra; epoch++) journal.append(reading(epoch));
+    // Sequence 1 went into slot 1, so the first sector held sector - 1 records of the first lap
+    TEST_ASSERT_EQUAL_UINT(sector - 1, journal.dropped());
+    TEST_ASSERT_EQUAL_UINT(JOURNAL_CAPACITY - sector + extra + 1, journal.pending());
+
+    Reading readings[BATCH];
+    TEST_ASSERT_EQUAL_UINT(BATCH, journal.peek(readings, BATCH));
+    TEST_ASSERT_EQUAL_UINT32(sector, readings[0].epoch);
+    TEST_ASSERT_EQUAL_UINT32(sector + BATCH - 1, readings[BATCH - 1].epoch);
+
+    // Drained to the end, the order holds across the wrap
+    uint32_t expected = sector;
+    while (journal.pending() > 0) {
+        size_t count = journal.peek(readings, BATCH);
+        TEST_ASSERT_TRUE(count > 0);
+        for (size_t i = 0; i < count; i++) TEST_ASSERT_EQUAL_UINT32(expected++, readings[i].epoch);
+        journal.pop(count);
+    }
+    TEST_ASSERT_EQUAL_UINT32(JOURNAL_CAPACITY + extra + 1, expected);
+}
+
+// Flash can only clear bits: over two laps, no record lands on bytes that were not erased first
+static void test_writes_only_erased_flash() {
+    for (uint32_t epoch = 1; epoch <= 2 * JOURNAL_CAPACITY + 5; epoch++) journal.append(reading(epoch));
+    TEST_ASSERT_EQUAL_UINT(0, store.unerasedWrites);
+
+    // A partition that was never erased: appending starts with the next sector, which is erased first
+    uint8_t zeros[64] = {0};
+    for (size_t offset = 0; offset < JOURNAL_CAPACITY * sizeof(JournalRecord); offset += sizeof(zeros)) {
+        store.write(offset, zeros, sizeof(zeros));
+    }
+    NativeHal::storage().clear();
+    store.unerasedWrites = 0;
+    Journal fresh;
+    TEST_ASSERT_TRUE(fresh.begin());
+    fresh.append(reading(7));
+    TEST_ASSERT_EQUAL_UINT(0, store.unerasedWrites);
+
+    Reading readings[BATCH];
+    TEST_ASSERT_EQUAL_UINT(1, fresh.peek(readings, BATCH));
+    TEST_ASSERT_EQUAL_UINT32(7, readings[0].epoch);
+}
+
+// A torn write: the readings before it are delivered, then it is dropped and the rest follows
+static void test_crc_mismatch_is_skipped() {
+    for (uint32_t epoch = 1; epoch <= 3; epoch++) journal.append(reading(epoch));
+    uint8_t flipped = 0xA5;
+    TEST_ASSERT_TRUE(store.write(slotOffset(2) + offsetof(JournalRecord, epoch), &flipped, 1));
+
+    Reading readings[BATCH];
+    TEST_ASSERT_EQUAL_UINT(1, journal.peek(readings, BATCH));
+    TEST_ASSERT_EQUAL_UINT32(1, readings[0].epoch);
+    journal.pop(1);
+
+    TEST_ASSERT_EQUAL_UINT(1, journal.peek(readings, BATCH));
+    TEST_ASSERT_EQUAL_UINT32(3, readings[0].epoch);
+    TEST_ASSERT_EQUAL_UINT(1, journal.dropped());
+    journal.pop(1);
+    TEST_ASSERT_EQUAL_UINT(0, journal.pending());
+}
+
+// The acknowledged position is saved every JOURNAL_ACK_EVERY deliveries: a reboot may repeat a few, never lose one
+static void test_backlog_survives_reboot() {
+    const uint32_t appended = JOURNAL_ACK_EVERY + 8;
+    for (uint32_t epoch = 1; epoch <= appended; epoch++) journal.append(reading(epoch));
+    for (uint32_t i = 0; i < JOURNAL_ACK_EVERY + 2; i++) journal.pop(1);    // One upload at a time
+
+    Journal rebooted;
+    TEST_ASSERT_TRUE(rebooted.begin());
+    TEST_ASSERT_EQUAL_UINT(appended - JOURNAL_ACK_EVERY, rebooted.pending());
+
+    Reading readings[BATCH];
+    TEST_ASSERT_EQUAL_UINT(1, rebooted.peek(readings, 1));
+    TEST_ASSERT_EQUAL_UINT32(JOURNAL_ACK_EVERY + 1, readings[0].epoch);
+
+    rebooted.append(reading(100));
+    TEST_ASSERT_EQUAL_UINT(appended - JOURNAL_ACK_EVERY + 1, rebooted.pending());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_oldest_first);
+    RUN_TEST(test_wrap_keeps_the_newest);
+    RUN_TEST(test_writes_only_erased_flash);
+    RUN_TEST(test_crc_mismatch_is_skipped);
+    RUN_TEST(test_backlog_survives_reboot);
+    return UNITY_END();
+}
@@ -0,0 +1,159 @@
+/*
+ * File: test_main.cpp
+ * Description: Upload and command encodings (Payload.h): readings encoded as JSON and MessagePack decode back to
+ *              the same fields, commands are read from both, and a body that does not fit is refused.
+ * Author: Andriy Tymchuk
+ * Created: 2026-10-17
+*/
+
+#include <ArduinoJson.h>
+#include <math.h>
+#include <unity.h>
+
+#include "ecomonitor/Payload.h"
+
+static const char* DEVICE_ID = "GG-4085A0A5";
+static uint8_t buffer[UPLOAD_PAYLOAD_SIZE];
+
+static Reading summary(uint32_t epoch, float value) {
+    Reading reading = {};
+    reading.epoch = epoch;
+    reading.value = value;
+    reading.min = value - 1.25f;
+    reading.max = value + 2.5f;
+    reading.mean = value + 0.125f;
+    reading.stddev = 0.75f;
+    reading.count = 180;
+    return reading;
+}
+
+static void decode(PayloadEncoding encoding, size_t length, JsonDocument& doc) {
+    TEST_ASSERT_TRUE(length > 0);
+    DeserializationError error = encoding == PAYLOAD_MSGPACK ? deserializeMsgPack(doc, buffer, length)
+                                                             : deserializeJson(doc, (const char*)buffer, length);
+    TEST_ASSERT_FALSE(error);
+    TEST_ASSERT_EQUAL_STRING(DEVICE_ID, doc["device_id"] | "");
+}
+
+static void checkSummary(JsonVariant decoded, const Reading& reading) {
+    TEST_ASSERT_EQUAL_FLOAT(reading.value, decoded["final_value"] | NAN);
+    TEST_ASSERT_EQUAL_UINT32(reading.epoch, decoded["timestamp"] | 0UL);
+    TEST_ASSERT_EQUAL_UINT(reading.count, decoded["count"] | 0U);
+    TEST_ASSERT_EQUAL_FLOAT(reading.min, decoded["min"] | NAN);
+    TEST_ASSERT_EQUAL_FLOAT(reading.max, decoded["max"] | NAN);
+    TEST_ASSERT_EQUAL_FLOAT(reading.mean, decoded["mean"] | NAN);
+    TEST_ASSERT_EQUAL_FLOAT(reading.stddev, decoded["stddev"] | NAN);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// A lone sample without a synchronised clock: no timestamp and no summary fields
+static void test_single_plain_reading() {
+    Reading reading = {};
+    reading.value = 0.7f;
+    reading.count = 1;
+    for (PayloadEncoding encoding : {PAYLOAD_JSON, PAYLOAD_MSGPACK}) {
+        JsonDocument doc;
+        decode(encoding, Payload::encodeReadings(DEVICE_ID, &reading, 1, encoding, buffer, sizeof(buffer)), doc);
+        TEST_ASSERT_EQUAL_FLOAT(0.7f, doc["final_value"] | NAN);
+        TEST_ASSERT_TRUE(doc["timestamp"].isNull());
+        TEST_ASSERT_TRUE(doc["count"].isNull());
+        TEST_ASSERT_TRUE(doc["alarm"].isNull());
+    }
+}
+
+static void test_single_summary_round_trips() {
+    Reading reading = summary(1768166087, 21.4375f);
+    for (PayloadEncoding encoding : {PAYLOAD_JSON, PAYLOAD_MSGPACK}) {
+        JsonDocument doc;
+        decode(encoding, Payload::encodeReadings(DEVICE_ID, &reading, 1, encoding, buffer, sizeof(buffer)), doc);
+        checkSummary(doc.as<JsonVariant>(), reading);
+    }
+}
+
+// A full batch with further channels and both alarm flags
+static void test_batch_round_trips() {
+    Reading readings[UPLOAD_BATCH_MAX];
+    for (size_t i = 0; i < UPLOAD_BATCH_MAX; i++) {
+        readings[i] = summary(1768166087 + 60 * i, 20.0f + i * 0.0625f);
+        readings[i].channelCount = 2;
+        readings[i].channels[0] = {CHANNEL_TEMPERATURE, 21.5f + i};
+        readings[i].channels[1] = {CHANNEL_HUMIDITY, 48.25f - i};
+    }
+    readings[3].alarm = ALARM_FLAG_RAISED;
+    readings[7].alarm = ALARM_FLAG_CLEARED;
+
+    for (PayloadEncoding encoding : {PAYLOAD_JSON, PAYLOAD_MSGPACK}) {
+        JsonDocument doc;
+        decode(encoding, Payload::encodeReadings(DEVICE_ID, readings, UPLOAD_BATCH_MAX, encoding, buffer, sizeof(buffer)), doc);
+        JsonArray list = doc["readings"].as<JsonArray>();
+        TEST_ASSERT_EQUAL_UINT(UPLOAD_BATCH_MAX, list.size());
+        for (size_t i = 0; i < UPLOAD_BATCH_MAX; i++) {
+            JsonVariant decoded = list[i];
+            checkSummary(decoded, readings[i]);
+            TEST_ASSERT_EQUAL_FLOAT(readings[i].channels[0].value, decoded["channels"]["temperature"] | NAN);
+            TEST_ASSERT_EQUAL_FLOAT(readings[i].channels[1].value, decoded["channels"]["humidity"] | NAN);
+        }
+        TEST_ASSERT_TRUE(list[3]["alarm"] | false);
+        TEST_ASSERT_FALSE(list[7]["alarm"] | true);
+        TEST_ASSERT_TRUE(list[0]["alarm"].isNull());
+    }
+}
+
+static void test_too_small_buffer_is_refused() {
+    Reading reading = summary(1768166087, 21.4375f);
+    uint8_t small[24];
+    TEST_ASSERT_EQUAL_UINT(0, Payload::encodeReadings(DEVICE_ID, &reading, 1, PAYLOAD_JSON, small, sizeof(small)));
+    TEST_ASSERT_EQUAL_UINT(0, Payload::encodeReadings(DEVICE_ID, &reading, 1, PAYLOAD_MSGPACK, small, sizeof(small)));
+}
+
+static void test_commands_decode_from_both_encodings() {
+    for (PayloadEncoding encoding : {PAYLOAD_JSON, PAYLOAD_MSGPACK}) {
+        JsonDocument doc;
+        doc["command"] = "change_reading_time";
+        doc["payload"] = "5";
+        doc["id"] = 17;         // Unknown fields are skipped
+        char body[128];
+        size_t length = encoding == PAYLOAD_MSGPACK ? serializeMsgPack(doc, body, sizeof(body))
+                                                    : serializeJson(doc, body, sizeof(body));
+        ApiCommand command;
+        TEST_ASSERT_TRUE(Payload::decodeCommand(body, length, Payload::contentType(encoding), command));
+        TEST_ASSERT_EQUAL_STRING("change_reading_time", command.command);
+        TEST_ASSERT_EQUAL_STRING("5", command.payload);
+    }
+}
+
+static void test_responses_without_command() {
+    ApiCommand command;
+    const char* empty = "{}";
+    const char* other = "{\"status\":\"ok\"}";
+    const char* broken = "{\"command\":";
+    TEST_ASSERT_FALSE(Payload::decodeCommand(empty, strlen(empty), CONTENT_TYPE_JSON, command));
+    TEST_ASSERT_FALSE(Payload::decodeCommand(other, strlen(other), CONTENT_TYPE_JSON, command));
+    TEST_ASSERT_FALSE(Payload::decodeCommand(broken, strlen(broken), CONTENT_TYPE_JSON, command));
+    TEST_ASSERT_FALSE(Payload::decodeCommand("", 0, CONTENT_TYPE_JSON, command));
+}
+
+static void test_content_types() {
+    TEST_ASSERT_EQUAL(PAYLOAD_MSGPACK, Payload::encodingOf("application/msgpack"));
+    TEST_ASSERT_EQUAL(PAYLOAD_MSGPACK, Payload::encodingOf("application/x-msgpack; charset=binary"));
+    TEST_ASSERT_EQUAL(PAYLOAD_JSON, Payload::encodingOf("application/json"));
+    TEST_ASSERT_EQUAL(PAYLOAD_JSON, Payload::encodingOf(nullptr));
+    PayloadEncoding encoding;
+    TEST_ASSERT_TRUE(Payload::encodingFromName("msgpack", encoding));
+    TEST_ASSERT_EQUAL(PAYLOAD_MSGPACK, encoding);
+    TEST_ASSERT_FALSE(Payload::encodingFromName("cbor", encoding));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_plain_reading);
+    RUN_TEST(test_single_summary_round_trips);
+    RUN_TEST(test_batch_round_trips);
+    RUN_TEST(test_too_small_buffer_is_refused);
+    RUN_TEST(test_commands_decode_from_both_encodings);
+    RUN_TEST(test_responses_without_command);
+    RUN_TEST(test_content_types);
+    return UNITY_END();
+}